@@ -11,6 +11,29 @@
 // the AVL tree acts like a binary search tree (e.g., it will become
 // degenerate if elements are added in ascending order).
 //
+// Where the nodes are allocated is decided by the NodeAllocator (see
+// NodeAllocator.hpp).  By default, each is allocated separately with new;
+// with an ArenaNodeAllocator, they're allocated together in large blocks,
+// which are freed all at once when the AVLSet is destroyed.
+//
+// A set of strings stores each one in its node as a CompactString (see
+// CompactString.hpp), which keeps the characters of most words within the
+// node itself.  The traversals hand the visit function a std::string made
+// from it.
+//
+// Searching and adding are both iterative, and compare the element with
+// each node's only once, with a three-way comparison (for strings, a
+// single std::string_view::compare()).  add() remembers the path it took
+// down the tree on a fixed-size stack, and walks back up it to update the
+// balance factors and do at most one (single or double) rotation.
+//
+// Rather than its height, each node keeps its balance factor (the height
+// of its right subtree minus that of its left, which in an AVL tree is
+// -1, 0, or 1), in the two low bits of its left pointer, which are always
+// zero since nodes are aligned to at least 4 bytes.  That makes a node of
+// strings 40 bytes rather than 48, and height() takes only O(log n) time,
+// following the taller subtree down from the root.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
 // in your data structure.  Instead, you'll need to implement your AVL tree
@@ -20,12 +43,19 @@
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "CompactString.hpp"
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 #include <algorithm>
 
 
-template <typename ElementType>
+template <typename ElementType, template <typename> class NodeAllocator = HeapNodeAllocator>
 class AVLSet : public Set<ElementType>
 {
 public:
@@ -65,18 +95,36 @@ public:
     virtual void add(const ElementType& element) override;
 
 
+    // bulkLoad() adds the given elements to the set.  When the set is
+    // empty, rather than adding them one at a time, it sorts them (unless
+    // they're sorted already) and builds a perfectly balanced tree from
+    // them directly, which takes linear time for sorted elements and needs
+    // no rotations either way.
+    virtual void bulkLoad(const ElementType* first, const ElementType* last) override;
+
+
+    using Set<ElementType>::contains;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function always runs in O(log n) time when
     // there are n elements in the AVL tree.
     virtual bool contains(const ElementType& element) const override;
 
 
+    // contains() can also be asked about a std::string_view; when the
+    // elements are strings, it is compared against them directly, so no
+    // std::string is constructed.
+    virtual bool contains(std::string_view element) const override;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
 
     // height() returns the height of the AVL tree.  Note that, by definition,
-    // the height of an empty tree is -1.
+    // the height of an empty tree is -1.  It runs in O(log n) time, unless
+    // balancing is off, in which case it visits every node.
     int height() const;
 
 
@@ -101,332 +149,654 @@ public:
 private:
     // You'll no doubt want to add member variables and "helper" member
     // functions here.
+
+    // left_and_balance is the left child's address, with the node's
+    // balance factor plus one in its two low bits; it's only read and
+    // written by leftOf(), setLeft(), balanceOf(), and setBalance().
     struct Node
     {
-        ElementType value;
-        Node* left;
+        NodeKey<ElementType> value;
+        std::uintptr_t left_and_balance;
         Node* right;
-        int node_height = 1;
-
     };
 
-    Node* root;
-    bool balance;
-    int current_size;
+    static_assert(alignof(Node) >= 4, "a Node's two low address bits must be free");
 
-    void copyAVLSet(Node* const &source, Node* &target) const;
-    bool containsHelper(Node* const &node, const ElementType& element) const;
-    void destroyTree(Node* &node) const;
-    int findHeight(Node* const &node) const;
-    int get_height(Node* node) const;
-    void insert(const ElementType& element, Node* &node) const;
-    void preorderHelper(Node* const &node, VisitFunction& visit) const;
-    void inorderHelper(Node* const &node, VisitFunction& visit) const;
-    void postorderHelper(Node* const &node, VisitFunction& visit) const;
+    static constexpr std::uintptr_t BALANCE_MASK = 3;
 
-    void rightRotate(Node* &node) const;
-    void leftRotate(Node* &node) const;
+    // An AVL tree of n nodes is less than 1.45 log2(n + 2) high, and
+    // current_size is an int, so no path from the root is longer than this.
+    static constexpr unsigned int MAX_PATH_LENGTH = 48;
 
+    NodeAllocator<Node> nodes;
+    Node* root;
+    bool balance;
+    int current_size;
 
+    static Node* leftOf(const Node* node) noexcept;
+    static void setLeft(Node* node, Node* left) noexcept;
+    static int balanceOf(const Node* node) noexcept;
+    static void setBalance(Node* node, int balanceFactor) noexcept;
+    static void setChild(Node* node, bool right, Node* child) noexcept;
+
+    template <typename KeyType>
+    static int compare(const KeyType& element, const NodeKey<ElementType>& value) noexcept;
+    template <typename KeyType>
+    bool search(const KeyType& element) const;
+
+    Node* newNode(const ElementType& element, int balanceFactor);
+    Node* copyTree(const Node* source);
+    Node* buildBalanced(const ElementType* const* sorted, std::size_t count, int& treeHeight);
+    void destroyTree(Node* node);
+    void destroyAll();
+    int findHeight(const Node* node) const;
+    void rebalancePath(Node* const* path, const bool* wentRight, unsigned int length);
+    static Node* rotateRightHeavy(Node* node) noexcept;
+    static Node* rotateLeftHeavy(Node* node) noexcept;
+    void preorderHelper(const Node* node, VisitFunction& visit) const;
+    void inorderHelper(const Node* node, VisitFunction& visit) const;
+    void postorderHelper(const Node* node, VisitFunction& visit) const;
 };
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(bool shouldBalance)
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(bool shouldBalance)
     : root{nullptr}, balance{shouldBalance}, current_size{0}
 {
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::~AVLSet() noexcept
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::~AVLSet() noexcept
 {
-    destroyTree(root);
+    destroyAll();
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(const AVLSet& s)
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(const AVLSet& s)
+    : root{nullptr}, balance{s.balance}, current_size{s.current_size}
 {
-    copyAVLSet(s.root, root);
-    balance = s.balance;
-    current_size = s.current_size;
+    root = copyTree(s.root);
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>::AVLSet(AVLSet&& s) noexcept
+    : root{nullptr}, balance{true}, current_size{0}
 {
-    root = nullptr;
+    std::swap(nodes, s.nodes);
     std::swap(root, s.root);
     std::swap(balance, s.balance);
     std::swap(current_size, s.current_size);
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>& AVLSet<ElementType, NodeAllocator>::operator=(const AVLSet& s)
 {
     if (this != &s)
     {
-        balance = s.balance;
-        current_size = s.current_size;
-
-        destroyTree(root);
-        copyAVLSet(s.root, root);
+        AVLSet copy{s};
+        *this = std::move(copy);
     }
     return *this;
 }
 
 
-template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
+template <typename ElementType, template <typename> class NodeAllocator>
+AVLSet<ElementType, NodeAllocator>& AVLSet<ElementType, NodeAllocator>::operator=(AVLSet&& s) noexcept
 {
     std::swap(balance, s.balance);
     std::swap(current_size, s.current_size);
+    std::swap(nodes, s.nodes);
     std::swap(root, s.root);
 
     return *this;
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, template <typename> class NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::isImplemented() const noexcept
 {
     return true;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::add(const ElementType& element)
 {
-    insert(element, root);
+    // When balancing, the nodes on the way down (and which way the search
+    // went from each) are remembered, so that rebalancePath() can walk
+    // back up them.  Without balancing, the path can be as long as the
+    // tree is large, but it isn't needed.
+    Node* path[MAX_PATH_LENGTH];
+    bool wentRight[MAX_PATH_LENGTH];
+    unsigned int length = 0;
+
+    Node* parent = nullptr;
+    bool right = false;
+
+    for (Node* node = root; node != nullptr; node = right ? node->right : leftOf(node))
+    {
+        int comparison = compare(element, node->value);
+
+        if (comparison == 0)
+        {
+            return;
+        }
+
+        parent = node;
+        right = comparison > 0;
+
+        if (balance)
+        {
+            path[length] = node;
+            wentRight[length] = right;
+            ++length;
+        }
+    }
+
+    Node* added = newNode(element, 0);
+
+    if (parent == nullptr)
+    {
+        root = added;
+    }
+    else
+    {
+        setChild(parent, right, added);
+    }
+
     current_size++;
+
+    if (balance)
+    {
+        rebalancePath(path, wentRight, length);
+    }
 }
 
 
-template <typename ElementType>
-bool AVLSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::bulkLoad(const ElementType* first, const ElementType* last)
 {
-    return containsHelper(root, element);
+    if (root != nullptr || first == last)
+    {
+        Set<ElementType>::bulkLoad(first, last);
+        return;
+    }
+
+    std::size_t count = static_cast<std::size_t>(last - first);
+    const ElementType** sorted = new const ElementType*[count];
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        sorted[i] = first + i;
+    }
+
+    try
+    {
+        if (!std::is_sorted(first, last))
+        {
+            std::sort(
+                sorted, sorted + count,
+                [](const ElementType* a, const ElementType* b) { return *a < *b; });
+        }
+
+        std::size_t unique = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (unique == 0 || *sorted[unique - 1] < *sorted[i])
+            {
+                sorted[unique++] = sorted[i];
+            }
+        }
+
+        int treeHeight = 0;
+        root = buildBalanced(sorted, unique, treeHeight);
+        current_size = static_cast<int>(unique);
+    }
+    catch (...)
+    {
+        delete[] sorted;
+        throw;
+    }
+
+    delete[] sorted;
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::contains(const ElementType& element) const
+{
+    return search(element);
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+bool AVLSet<ElementType, NodeAllocator>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string>)
+    {
+        return search(element);
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
+    }
 }
 
 
-template <typename ElementType>
-unsigned int AVLSet<ElementType>::size() const noexcept
+template <typename ElementType, template <typename> class NodeAllocator>
+unsigned int AVLSet<ElementType, NodeAllocator>::size() const noexcept
 {
     return current_size;
 }
 
 
-template <typename ElementType>
-int AVLSet<ElementType>::height() const
+template <typename ElementType, template <typename> class NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::height() const
 {
-    return findHeight(root);
+    if (!balance)
+    {
+        return findHeight(root);
+    }
+
+    // Following the taller subtree of each node (either, if they're the
+    // same height) leads down a longest path from the root.
+    int treeHeight = -1;
+
+    for (const Node* node = root; node != nullptr; node = balanceOf(node) > 0 ? node->right : leftOf(node))
+    {
+        ++treeHeight;
+    }
+
+    return treeHeight;
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::preorder(VisitFunction visit) const
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::preorder(VisitFunction visit) const
 {
     preorderHelper(root, visit);
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::inorder(VisitFunction visit) const
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::inorder(VisitFunction visit) const
 {
     inorderHelper(root, visit);
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::postorder(VisitFunction visit) const
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::postorder(VisitFunction visit) const
 {
     postorderHelper(root, visit);
 }
 
-template<typename ElementType>
-void AVLSet<ElementType>::copyAVLSet(Node* const &source, Node* &target) const
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::leftOf(
+    const Node* node) noexcept
 {
-    if (source == nullptr)
+    return reinterpret_cast<Node*>(node->left_and_balance & ~BALANCE_MASK);
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::setLeft(Node* node, Node* left) noexcept
+{
+    node->left_and_balance = reinterpret_cast<std::uintptr_t>(left) | (node->left_and_balance & BALANCE_MASK);
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::balanceOf(const Node* node) noexcept
+{
+    return static_cast<int>(node->left_and_balance & BALANCE_MASK) - 1;
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::setBalance(Node* node, int balanceFactor) noexcept
+{
+    node->left_and_balance =
+        (node->left_and_balance & ~BALANCE_MASK) | static_cast<std::uintptr_t>(balanceFactor + 1);
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::setChild(Node* node, bool right, Node* child) noexcept
+{
+    if (right)
     {
-        target = nullptr;
+        node->right = child;
     }
     else
     {
-        target = new Node{source->value, nullptr, nullptr, 1};
-        copyAVLSet(source->left, target->left);
-        copyAVLSet(source->right, target->right);
+        setLeft(node, child);
     }
 }
 
-template <typename ElementType>
-bool AVLSet<ElementType>::containsHelper(Node* const &node, const ElementType& element) const
+
+// compare() returns a negative number if the element is less than the
+// value in a node, zero if they're equal, and a positive number if it's
+// greater.  Strings are compared just once, with compare(); anything else
+// is compared with < (twice, but only when it isn't less).
+
+template <typename ElementType, template <typename> class NodeAllocator>
+template <typename KeyType>
+int AVLSet<ElementType, NodeAllocator>::compare(
+    const KeyType& element, const NodeKey<ElementType>& value) noexcept
 {
-    if (node == nullptr)
+    if constexpr (std::is_same_v<NodeKey<ElementType>, CompactString>)
+    {
+        return std::string_view{element}.compare(value.view());
+    }
+    else
+    {
+        return element < value ? -1 : (value < element ? 1 : 0);
+    }
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+template <typename KeyType>
+bool AVLSet<ElementType, NodeAllocator>::search(const KeyType& element) const
+{
+    const Node* node = root;
+
+    while (node != nullptr)
+    {
+        int comparison = compare(element, node->value);
+
+        if (comparison == 0)
+        {
+            return true;
+        }
+
+        node = comparison < 0 ? leftOf(node) : node->right;
+    }
+
+    return false;
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::newNode(
+    const ElementType& element, int balanceFactor)
+{
+    return nodes.create(element, static_cast<std::uintptr_t>(balanceFactor + 1), nullptr);
+}
+
+
+// copyTree() returns a copy of the tree rooted at the given node, balance
+// factors and all.  If an allocation fails, whatever was copied so far is
+// destroyed.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::copyTree(
+    const Node* source)
+{
+    if (source == nullptr)
+    {
+        return nullptr;
+    }
+
+    Node* target = nodes.create(source->value, source->left_and_balance & BALANCE_MASK, nullptr);
+
+    try
+    {
+        setLeft(target, copyTree(leftOf(source)));
+        target->right = copyTree(source->right);
+    }
+    catch (...)
+    {
+        destroyTree(target);
+        throw;
+    }
+
+    return target;
+}
+
+
+// buildBalanced() builds a tree from the given sorted elements by making
+// the middle one the root and building its subtrees from the elements on
+// either side of it, and sets treeHeight to the number of levels in it.
+// If an allocation fails, whatever was built so far is destroyed.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::buildBalanced(
+    const ElementType* const* sorted, std::size_t count, int& treeHeight)
+{
+    if (count == 0)
+    {
+        treeHeight = 0;
+        return nullptr;
+    }
+
+    std::size_t middle = count / 2;
+    int leftHeight = 0;
+    int rightHeight = 0;
+    Node* left = buildBalanced(sorted, middle, leftHeight);
+    Node* node = nullptr;
+
+    try
+    {
+        node = newNode(*sorted[middle], 0);
+        setLeft(node, left);
+    }
+    catch (...)
+    {
+        destroyTree(left);
+        throw;
+    }
+
+    try
     {
-        return false;
+        node->right = buildBalanced(sorted + middle + 1, count - middle - 1, rightHeight);
     }
-    else if (node->value == element)
+    catch (...)
     {
-        return true;
+        destroyTree(node);
+        throw;
     }
-    return containsHelper(node->left, element) || containsHelper(node->right, element);
+
+    setBalance(node, rightHeight - leftHeight);
+    treeHeight = 1 + std::max(leftHeight, rightHeight);
+    return node;
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::destroyTree(Node* &node) const
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::destroyTree(Node* node)
 {
     if (node != nullptr)
     {
-        destroyTree(node->left);
+        destroyTree(leftOf(node));
         destroyTree(node->right);
-        delete node;
+        nodes.destroy(node);
     }
-    node = nullptr;
 }
 
-/*template <typename ElementType>
-int AVLSet<ElementType>::findHeight(Node* const &node) const
+
+// destroyAll() destroys every node in the tree, which an allocator that
+// destroys all of its nodes at once can do without visiting them.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::destroyAll()
 {
-    if (node == nullptr)
+    if constexpr (NodeAllocator<Node>::DESTROYS_ALL_AT_ONCE)
     {
-        return -1;
+        nodes.destroyAll();
     }
-    node->node_height = 1 + std::max(findHeight(node->left), findHeight(node->right));
-    return node->node_height;
-}*/
-// height running in o(n)?
-template <typename ElementType>
-int AVLSet<ElementType>::findHeight(Node* const &node) const
-{
-    if (node == nullptr)
+    else
     {
-        return -1;
+        destroyTree(root);
     }
-    node->node_height = 1 + std::max(findHeight(node->left), findHeight(node->right));
-    return node->node_height;
+
+    root = nullptr;
 }
 
-template <typename ElementType>
-int AVLSet<ElementType>::get_height(Node* node) const
+
+// findHeight() finds the height of a tree without balancing, whose balance
+// factors aren't kept, by visiting all of its nodes.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+int AVLSet<ElementType, NodeAllocator>::findHeight(const Node* node) const
 {
     if (node == nullptr)
     {
-        return 0;
+        return -1;
     }
-    return node->node_height;
+
+    return 1 + std::max(findHeight(leftOf(node)), findHeight(node->right));
 }
 
 
-template <typename ElementType>
-void AVLSet<ElementType>::insert(const ElementType& element, Node* &node) const
+// rebalancePath() is called after a node is added below the last node on
+// the given path from the root, walking back up the path and updating the
+// balance factors of the nodes whose subtrees have grown taller.  It stops
+// at the first node whose subtree hasn't, or at the first node that's now
+// unbalanced, whose subtree a rotation returns to its old height.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::rebalancePath(
+    Node* const* path, const bool* wentRight, unsigned int length)
 {
-    if (!contains(element))
+    for (unsigned int i = length; i-- > 0; )
     {
-        if (node == nullptr)
+        Node* node = path[i];
+        int balanceFactor = balanceOf(node) + (wentRight[i] ? 1 : -1);
+
+        if (balanceFactor == 0)
         {
-            node = new Node{element, nullptr, nullptr, 1};
+            setBalance(node, 0);
+            return;
         }
-        else if (node->value < element)
+        else if (balanceFactor == 1 || balanceFactor == -1)
         {
-            insert(element, node->right);
+            setBalance(node, balanceFactor);
+            continue;
         }
-        else if (node->value > element)
+
+        Node* top = balanceFactor > 0 ? rotateRightHeavy(node) : rotateLeftHeavy(node);
+
+        if (i == 0)
         {
-            insert(element, node->left);
+            root = top;
         }
-
-        if (balance)
+        else
         {
-            node->node_height = findHeight(node);
-            int height_difference = findHeight(node->left) - findHeight(node->right);
-
-            if (height_difference > 1 && element < node->left->value)
-            {
-                rightRotate(node);
-            }
-            if (height_difference < -1 && element > node->right->value)
-            {
-                leftRotate(node);
-            }
-            if (height_difference > 1 && element > node->left->value)
-            {
-                leftRotate(node->left);
-                rightRotate(node);
-            }
-            if (height_difference < -1 && element < node->right->value)
-            {
-                rightRotate(node->right);
-                leftRotate(node);
-            }
+            setChild(path[i - 1], wentRight[i - 1], top);
         }
+
+        return;
+    }
+}
+
+
+// rotateRightHeavy() rebalances a subtree whose right subtree has just
+// grown two levels taller than its left, with a left rotation if the
+// right child is itself right-heavy, or a right-left double rotation
+// otherwise, and returns the subtree's new root.  rotateLeftHeavy() is its
+// mirror image.
+
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::rotateRightHeavy(
+    Node* node) noexcept
+{
+    Node* child = node->right;
+
+    if (balanceOf(child) > 0)
+    {
+        node->right = leftOf(child);
+        setLeft(child, node);
+        setBalance(node, 0);
+        setBalance(child, 0);
+        return child;
     }
 
+    Node* grandchild = leftOf(child);
+    int grandchildBalance = balanceOf(grandchild);
+
+    setLeft(child, grandchild->right);
+    grandchild->right = child;
+    node->right = leftOf(grandchild);
+    setLeft(grandchild, node);
+
+    setBalance(node, grandchildBalance > 0 ? -1 : 0);
+    setBalance(child, grandchildBalance < 0 ? 1 : 0);
+    setBalance(grandchild, 0);
+    return grandchild;
+}
+
+
+template <typename ElementType, template <typename> class NodeAllocator>
+typename AVLSet<ElementType, NodeAllocator>::Node* AVLSet<ElementType, NodeAllocator>::rotateLeftHeavy(
+    Node* node) noexcept
+{
+    Node* child = leftOf(node);
+
+    if (balanceOf(child) < 0)
+    {
+        setLeft(node, child->right);
+        child->right = node;
+        setBalance(node, 0);
+        setBalance(child, 0);
+        return child;
+    }
+
+    Node* grandchild = child->right;
+    int grandchildBalance = balanceOf(grandchild);
+
+    child->right = leftOf(grandchild);
+    setLeft(grandchild, child);
+    setLeft(node, grandchild->right);
+    grandchild->right = node;
+
+    setBalance(node, grandchildBalance < 0 ? 1 : 0);
+    setBalance(child, grandchildBalance > 0 ? -1 : 0);
+    setBalance(grandchild, 0);
+    return grandchild;
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::preorderHelper(Node* const &node, VisitFunction& visit) const 
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::preorderHelper(const Node* node, VisitFunction& visit) const
 {
     if (node != nullptr)
     {
-        visit(node->value);
-        preorderHelper(node->left, visit);
+        visit(elementOf<ElementType>(node->value));
+        preorderHelper(leftOf(node), visit);
         preorderHelper(node->right, visit);
     }
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::inorderHelper(Node* const &node, VisitFunction& visit) const
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::inorderHelper(const Node* node, VisitFunction& visit) const
 {
     if (node != nullptr)
     {
-        inorderHelper(node->left, visit);
-        visit(node->value);
+        inorderHelper(leftOf(node), visit);
+        visit(elementOf<ElementType>(node->value));
         inorderHelper(node->right, visit);
     }
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::postorderHelper(Node* const &node, VisitFunction& visit) const
+
+template <typename ElementType, template <typename> class NodeAllocator>
+void AVLSet<ElementType, NodeAllocator>::postorderHelper(const Node* node, VisitFunction& visit) const
 {
     if (node != nullptr)
     {
-        postorderHelper(node->left, visit);
+        postorderHelper(leftOf(node), visit);
         postorderHelper(node->right, visit);
-        visit(node->value);
+        visit(elementOf<ElementType>(node->value));
     }
 }
 
-template <typename ElementType>
-void AVLSet<ElementType>::rightRotate(Node* &node) const
-{
-    Node* x = node->left;
-
-    node->left = x->right;
-    x->right = node;
-
-    node->node_height = std::max(get_height(node->left), get_height(node->right)) + 1;
-    x->node_height = std::max(get_height(x->left), get_height(x->right)) + 1;
-
-    node = x;
-
-}
-
-template <typename ElementType>
-void AVLSet<ElementType>::leftRotate(Node* &node) const
-{
-    Node* x = node->right;
-
-    node->right = x->left;
-    x->left = node;
-
-    node->node_height = std::max(get_height(node->left), get_height(node->right)) + 1;
-    x->node_height = std::max(get_height(x->left), get_height(x->right)) + 1;
-
-    node = x;
-}
 
 
 #endif // AVLSET_HPP
-
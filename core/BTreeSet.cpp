@@ -0,0 +1,680 @@
+// BTreeSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include "BTreeSet.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+
+namespace
+{
+    // The fingerprint given to the slots beyond a node's last key, which
+    // is never less than any other.
+    constexpr std::int32_t NO_FINGERPRINT = INT32_MAX;
+
+
+    unsigned int countBits(unsigned int bits) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_popcount(bits));
+#else
+        unsigned int count = 0;
+
+        for (; bits != 0; bits &= bits - 1)
+        {
+            ++count;
+        }
+
+        return count;
+#endif
+    }
+
+
+    std::size_t commonPrefixLength(std::string_view a, std::string_view b) noexcept
+    {
+        std::size_t length = std::min(a.size(), b.size());
+        std::size_t i = 0;
+
+        while (i < length && a[i] == b[i])
+        {
+            ++i;
+        }
+
+        return i;
+    }
+}
+
+
+
+BTreeSet::BTreeSet()
+    : root{nullptr}, current_size{0}
+{
+}
+
+
+BTreeSet::~BTreeSet() noexcept
+{
+    destroyTree(root);
+}
+
+
+BTreeSet::BTreeSet(const BTreeSet& s)
+    : root{nullptr}, current_size{s.current_size}
+{
+    if (s.root != nullptr)
+    {
+        Leaf* previous = nullptr;
+        root = copyTree(s.root, previous);
+    }
+}
+
+
+BTreeSet::BTreeSet(BTreeSet&& s) noexcept
+    : root{nullptr}, current_size{0}
+{
+    std::swap(root, s.root);
+    std::swap(current_size, s.current_size);
+}
+
+
+BTreeSet& BTreeSet::operator=(const BTreeSet& s)
+{
+    if (this != &s)
+    {
+        BTreeSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+BTreeSet& BTreeSet::operator=(BTreeSet&& s) noexcept
+{
+    std::swap(root, s.root);
+    std::swap(current_size, s.current_size);
+    return *this;
+}
+
+
+bool BTreeSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void BTreeSet::add(const std::string& element)
+{
+    if (contains(std::string_view{element}))
+    {
+        return;
+    }
+
+    Fence none{false, std::string_view{}};
+
+    if (root == nullptr)
+    {
+        root = newLeaf();
+    }
+    else if (root->count == CAPACITY)
+    {
+        Inner* newRoot = newInner();
+        newRoot->children[0] = root;
+        root = newRoot;
+        splitChild(newRoot, 0, none, none);
+    }
+
+    // Each full child is split before the search descends into it, so
+    // there's always room in a node for a separator from below.
+    Node* node = root;
+    Fence lower = none;
+    Fence upper = none;
+
+    while (!node->is_leaf)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        unsigned int i = upperRank(inner, element);
+
+        if (inner->children[i]->count == CAPACITY)
+        {
+            splitChild(inner, i, lower, upper);
+
+            if (!(element < inner->keys[i]))
+            {
+                ++i;
+            }
+        }
+
+        lower = i > 0 ? Fence{true, inner->keys[i - 1].view()} : lower;
+        upper = i < inner->count ? Fence{true, inner->keys[i].view()} : upper;
+        node = inner->children[i];
+    }
+
+    unsigned int position = lowerRank(node, element);
+
+    std::move_backward(node->keys + position, node->keys + node->count, node->keys + node->count + 1);
+    std::move_backward(
+        node->fingerprints + position, node->fingerprints + node->count,
+        node->fingerprints + node->count + 1);
+
+    node->keys[position] = CompactString{element};
+    node->count++;
+    setFingerprint(node, position);
+    current_size++;
+}
+
+
+void BTreeSet::bulkLoad(const std::string* first, const std::string* last)
+{
+    if (root != nullptr || first == last)
+    {
+        Set<std::string>::bulkLoad(first, last);
+        return;
+    }
+
+    unsigned int count = static_cast<unsigned int>(last - first);
+    const std::string** sorted = new const std::string*[count];
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        sorted[i] = first + i;
+    }
+
+    try
+    {
+        auto isLessThan = [](const std::string* a, const std::string* b) { return *a < *b; };
+
+        if (!std::is_sorted(first, last))
+        {
+            std::sort(sorted, sorted + count, isLessThan);
+        }
+
+        unsigned int unique = 0;
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (unique == 0 || *sorted[unique - 1] < *sorted[i])
+            {
+                sorted[unique++] = sorted[i];
+            }
+        }
+
+        build(sorted, unique);
+    }
+    catch (...)
+    {
+        delete[] sorted;
+        throw;
+    }
+
+    delete[] sorted;
+}
+
+
+bool BTreeSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool BTreeSet::contains(std::string_view element) const
+{
+    unsigned int position = 0;
+    const Leaf* leaf = findLeaf(element, position);
+
+    return leaf != nullptr && position < leaf->count && leaf->keys[position] == element;
+}
+
+
+unsigned int BTreeSet::size() const noexcept
+{
+    return current_size;
+}
+
+
+int BTreeSet::height() const noexcept
+{
+    if (root == nullptr)
+    {
+        return -1;
+    }
+
+    int height = 0;
+
+    for (const Node* node = root; !node->is_leaf; node = static_cast<const Inner*>(node)->children[0])
+    {
+        ++height;
+    }
+
+    return height;
+}
+
+
+unsigned int BTreeSet::lowerRank(const Node* node, std::string_view word) noexcept
+{
+    return rank(node, word, false);
+}
+
+
+unsigned int BTreeSet::upperRank(const Node* node, std::string_view word) noexcept
+{
+    return rank(node, word, true);
+}
+
+
+// rank() returns the number of keys in the node that are less than the
+// given word (or, if countEqual is true, less than or equal to it).
+//
+// The keys are sorted, and so are their fingerprints, so the keys whose
+// fingerprints are less than the word's come first, followed by any whose
+// fingerprints are equal to it.  The former are all less than the word,
+// so they're counted without looking at them; only the latter are
+// compared with it.
+
+unsigned int BTreeSet::rank(const Node* node, std::string_view word, bool countEqual) noexcept
+{
+    std::int32_t target = fingerprintOf(word, node->prefix_length);
+    unsigned int less = 0;
+    unsigned int equal = 0;
+
+#if defined(__SSE2__)
+    __m128i targets = _mm_set1_epi32(target);
+    const __m128i* fingerprints = reinterpret_cast<const __m128i*>(node->fingerprints);
+
+    for (unsigned int i = 0; i < CAPACITY / 4; ++i)
+    {
+        __m128i group = _mm_load_si128(fingerprints + i);
+        less |= static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(group, targets)))) << (4 * i);
+        equal |= static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(group, targets)))) << (4 * i);
+    }
+#else
+    for (unsigned int i = 0; i < CAPACITY; ++i)
+    {
+        less |= static_cast<unsigned int>(node->fingerprints[i] < target) << i;
+        equal |= static_cast<unsigned int>(node->fingerprints[i] == target) << i;
+    }
+#endif
+
+    unsigned int keys = (1u << node->count) - 1;
+    unsigned int result = countBits(less & keys);
+    equal &= keys;
+
+    for (unsigned int i = result; i < node->count && (equal & (1u << i)) != 0; ++i)
+    {
+        int comparison = word.compare(node->keys[i].view());
+
+        if (comparison < 0 || (comparison == 0 && !countEqual))
+        {
+            break;
+        }
+
+        ++result;
+    }
+
+    return result;
+}
+
+
+// fingerprintOf() returns the fingerprint of the word in a node whose keys
+// share their first prefixLength characters: the 4 characters after them,
+// as a big-endian integer (padded with zeroes), with its sign bit flipped.
+
+std::int32_t BTreeSet::fingerprintOf(std::string_view word, unsigned int prefixLength) noexcept
+{
+    std::uint32_t fingerprint = 0;
+
+    if (word.size() >= prefixLength + 4u)
+    {
+        // Compilers turn this into a single load and byte swap.
+        const unsigned char* c = reinterpret_cast<const unsigned char*>(word.data() + prefixLength);
+        fingerprint =
+            (std::uint32_t{c[0]} << 24) | (std::uint32_t{c[1]} << 16)
+            | (std::uint32_t{c[2]} << 8) | std::uint32_t{c[3]};
+
+        return static_cast<std::int32_t>(fingerprint ^ 0x80000000u);
+    }
+
+    for (std::size_t i = prefixLength; i < prefixLength + 4; ++i)
+    {
+        fingerprint <<= 8;
+
+        if (i < word.size())
+        {
+            fingerprint |= static_cast<unsigned char>(word[i]);
+        }
+    }
+
+    return static_cast<std::int32_t>(fingerprint ^ 0x80000000u);
+}
+
+
+// findLeaf() returns the leaf in which the given word belongs, and sets
+// position to the number of its words that are less than the given one.
+// (If that's all of them, the words after it begin in the next leaf.)
+
+const BTreeSet::Leaf* BTreeSet::findLeaf(std::string_view word, unsigned int& position) const noexcept
+{
+    if (root == nullptr)
+    {
+        return nullptr;
+    }
+
+    const Node* node = root;
+
+    while (!node->is_leaf)
+    {
+        node = static_cast<const Inner*>(node)->children[upperRank(node, word)];
+    }
+
+    position = lowerRank(node, word);
+    return static_cast<const Leaf*>(node);
+}
+
+
+// setFences() gives the node the prefix length that its fences imply and
+// recalculates all of its fingerprints accordingly.  A node at either end
+// of the tree has only one fence, so its keys needn't have anything in
+// common.
+
+void BTreeSet::setFences(Node* node, Fence lower, Fence upper) noexcept
+{
+    std::size_t prefixLength = 0;
+
+    if (lower.exists && upper.exists)
+    {
+        prefixLength = std::min(commonPrefixLength(lower.key, upper.key), std::size_t{UCHAR_MAX});
+    }
+
+    node->prefix_length = static_cast<unsigned char>(prefixLength);
+
+    for (unsigned int i = 0; i < CAPACITY; ++i)
+    {
+        setFingerprint(node, i);
+    }
+}
+
+
+void BTreeSet::setFingerprint(Node* node, unsigned int i) noexcept
+{
+    node->fingerprints[i] =
+        i < node->count ? fingerprintOf(node->keys[i].view(), node->prefix_length) : NO_FINGERPRINT;
+}
+
+
+// splitChild() splits the full child at the given index of the parent (whose
+// own fences are given) into two, moving the upper half of its keys into a
+// new node to its right, and adds a separator between them to the parent,
+// which mustn't be full.  Splitting a leaf copies the new node's first key
+// into the parent; splitting an inner node moves its middle key there.
+
+void BTreeSet::splitChild(Inner* parent, unsigned int index, Fence lower, Fence upper)
+{
+    constexpr unsigned int HALF = CAPACITY / 2;
+
+    Node* left = parent->children[index];
+    Node* right = nullptr;
+    CompactString separator;
+
+    if (left->is_leaf)
+    {
+        Leaf* leftLeaf = static_cast<Leaf*>(left);
+        Leaf* rightLeaf = newLeaf();
+
+        std::move(leftLeaf->keys + HALF, leftLeaf->keys + CAPACITY, rightLeaf->keys);
+        rightLeaf->count = CAPACITY - HALF;
+        leftLeaf->count = HALF;
+
+        rightLeaf->next = leftLeaf->next;
+        leftLeaf->next = rightLeaf;
+
+        separator = rightLeaf->keys[0];
+        right = rightLeaf;
+    }
+    else
+    {
+        Inner* leftInner = static_cast<Inner*>(left);
+        Inner* rightInner = newInner();
+
+        separator = std::move(leftInner->keys[HALF]);
+        std::move(leftInner->keys + HALF + 1, leftInner->keys + CAPACITY, rightInner->keys);
+        std::copy(leftInner->children + HALF + 1, leftInner->children + CAPACITY + 1, rightInner->children);
+        rightInner->count = CAPACITY - HALF - 1;
+        leftInner->count = HALF;
+
+        right = rightInner;
+    }
+
+    std::move_backward(parent->keys + index, parent->keys + parent->count, parent->keys + parent->count + 1);
+    std::copy_backward(
+        parent->children + index + 1, parent->children + parent->count + 1,
+        parent->children + parent->count + 2);
+
+    parent->keys[index] = std::move(separator);
+    parent->children[index + 1] = right;
+    parent->count++;
+
+    for (unsigned int i = index; i < parent->count; ++i)
+    {
+        setFingerprint(parent, i);
+    }
+
+    Fence leftLower = index > 0 ? Fence{true, parent->keys[index - 1].view()} : lower;
+    Fence middle{true, parent->keys[index].view()};
+    Fence rightUpper = index + 1 < parent->count ? Fence{true, parent->keys[index + 1].view()} : upper;
+
+    setFences(left, leftLower, middle);
+    setFences(right, middle, rightUpper);
+}
+
+
+BTreeSet::Leaf* BTreeSet::newLeaf()
+{
+    Leaf* leaf = new Leaf{};
+    leaf->is_leaf = true;
+    leaf->next = nullptr;
+    std::fill(leaf->fingerprints, leaf->fingerprints + CAPACITY, NO_FINGERPRINT);
+    return leaf;
+}
+
+
+BTreeSet::Inner* BTreeSet::newInner()
+{
+    Inner* inner = new Inner{};
+    inner->is_leaf = false;
+    std::fill(inner->fingerprints, inner->fingerprints + CAPACITY, NO_FINGERPRINT);
+    std::fill(inner->children, inner->children + CAPACITY + 1, nullptr);
+    return inner;
+}
+
+
+// build() builds the tree from the given sorted, distinct words, one level
+// at a time from the leaves up, spreading each level's keys (or children)
+// as evenly as possible across the fewest nodes that can hold them.  The
+// fingerprints are calculated once the whole tree has been built, since
+// until then, the nodes' fences aren't known.
+
+void BTreeSet::build(const std::string* const* sorted, unsigned int count)
+{
+    unsigned int levelCount = (count + CAPACITY - 1) / CAPACITY;
+    Node** level = new Node*[levelCount]();
+    std::string_view* lowest = nullptr;
+
+    try
+    {
+        lowest = new std::string_view[levelCount];
+        Leaf* previous = nullptr;
+        unsigned int next = 0;
+
+        for (unsigned int j = 0; j < levelCount; ++j)
+        {
+            Leaf* leaf = newLeaf();
+            level[j] = leaf;
+
+            unsigned int keys = count / levelCount + (j < count % levelCount ? 1 : 0);
+
+            for (unsigned int i = 0; i < keys; ++i)
+            {
+                leaf->keys[i] = CompactString{*sorted[next++]};
+            }
+
+            leaf->count = static_cast<unsigned char>(keys);
+            lowest[j] = leaf->keys[0].view();
+
+            if (previous != nullptr)
+            {
+                previous->next = leaf;
+            }
+
+            previous = leaf;
+        }
+
+        while (levelCount > 1)
+        {
+            unsigned int parentCount = (levelCount + CAPACITY) / (CAPACITY + 1);
+            unsigned int child = 0;
+
+            for (unsigned int j = 0; j < parentCount; ++j)
+            {
+                Inner* parent = newInner();
+                unsigned int children = levelCount / parentCount + (j < levelCount % parentCount ? 1 : 0);
+                std::string_view parentLowest = lowest[child];
+
+                for (unsigned int i = 0; i < children; ++i)
+                {
+                    parent->children[i] = level[child + i];
+                    level[child + i] = nullptr;
+                }
+
+                parent->count = static_cast<unsigned char>(children - 1);
+                level[j] = parent;
+
+                for (unsigned int i = 1; i < children; ++i)
+                {
+                    parent->keys[i - 1] = CompactString{lowest[child + i]};
+                }
+
+                child += children;
+                lowest[j] = parentLowest;
+            }
+
+            levelCount = parentCount;
+        }
+    }
+    catch (...)
+    {
+        for (unsigned int j = 0; j < levelCount; ++j)
+        {
+            destroyTree(level[j]);
+        }
+
+        delete[] level;
+        delete[] lowest;
+        throw;
+    }
+
+    root = level[0];
+    current_size = count;
+
+    delete[] level;
+    delete[] lowest;
+
+    setAllFences(root, Fence{false, std::string_view{}}, Fence{false, std::string_view{}});
+}
+
+
+void BTreeSet::setAllFences(Node* node, Fence lower, Fence upper) noexcept
+{
+    setFences(node, lower, upper);
+
+    if (!node->is_leaf)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+
+        for (unsigned int i = 0; i <= inner->count; ++i)
+        {
+            setAllFences(
+                inner->children[i],
+                i > 0 ? Fence{true, inner->keys[i - 1].view()} : lower,
+                i < inner->count ? Fence{true, inner->keys[i].view()} : upper);
+        }
+    }
+}
+
+
+// copyTree() copies the tree rooted at the given node, linking each leaf it
+// copies to the one copied before it.
+
+BTreeSet::Node* BTreeSet::copyTree(const Node* node, Leaf*& previous)
+{
+    if (node->is_leaf)
+    {
+        Leaf* leaf = newLeaf();
+        std::copy(node->keys, node->keys + node->count, leaf->keys);
+        std::copy(node->fingerprints, node->fingerprints + CAPACITY, leaf->fingerprints);
+        leaf->count = node->count;
+        leaf->prefix_length = node->prefix_length;
+
+        if (previous != nullptr)
+        {
+            previous->next = leaf;
+        }
+
+        previous = leaf;
+        return leaf;
+    }
+
+    const Inner* source = static_cast<const Inner*>(node);
+    Inner* inner = newInner();
+
+    try
+    {
+        std::copy(source->keys, source->keys + source->count, inner->keys);
+        std::copy(source->fingerprints, source->fingerprints + CAPACITY, inner->fingerprints);
+        inner->count = source->count;
+        inner->prefix_length = source->prefix_length;
+
+        for (unsigned int i = 0; i <= source->count; ++i)
+        {
+            inner->children[i] = copyTree(source->children[i], previous);
+        }
+    }
+    catch (...)
+    {
+        destroyTree(inner);
+        throw;
+    }
+
+    return inner;
+}
+
+
+void BTreeSet::destroyTree(Node* node) noexcept
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    if (node->is_leaf)
+    {
+        delete static_cast<Leaf*>(node);
+    }
+    else
+    {
+        Inner* inner = static_cast<Inner*>(node);
+
+        for (unsigned int i = 0; i <= inner->count; ++i)
+        {
+            destroyTree(inner->children[i]);
+        }
+
+        delete inner;
+    }
+}
@@ -0,0 +1,253 @@
+// BTreeSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BTreeSet is an implementation of a Set of strings that is a B+-tree:
+// a balanced search tree whose nodes each hold up to CAPACITY (16) keys,
+// with all of the words kept in the leaves, in sorted order, and each leaf
+// linked to the next.  A lookup in a set of n words visits only about
+// log16(n) nodes, rather than the log2(n) of a binary tree like an
+// AVLSet, and the leaves can be walked in order to visit a range of words
+// (such as all of those beginning with a given prefix).
+//
+// A node's keys are searched without looking at the keys themselves in
+// most cases.  Alongside them, each node keeps a 4-byte "fingerprint" of
+// each key, all 16 of which fill exactly one 64-byte cache line, and
+// which are compared with the fingerprint of the word being searched for
+// all at once, using SSE2 instructions where they're available.  Only
+// keys whose fingerprints are equal to the word's have to be compared
+// with it character by character.
+//
+// The fingerprints are prefix-compressed.  The keys in a node all lie
+// between the two separators in its parent on either side of it (its
+// "fences"), so they all begin with whatever characters the fences have
+// in common, and so does any word that a search leads to the node.  Each
+// node's fingerprints are therefore made from the 4 characters that follow
+// that common prefix, which are the ones that actually tell its keys
+// apart.  (The fingerprint is those characters as a big-endian integer,
+// padded with zeroes, so comparing fingerprints compares the characters
+// in order.)
+//
+// The keys themselves are CompactStrings, so most of them don't need a
+// separate allocation.
+//
+// add() splits full nodes on the way down, so the insertion never has to
+// go back up the tree.  bulkLoad() into an empty set builds the tree from
+// the bottom up, with full leaves, instead.
+//
+// Like TrieSet, this uses std::string_view, rather than ElementType, for
+// the words it visits.
+
+#ifndef BTREESET_HPP
+#define BTREESET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "CompactString.hpp"
+#include "Set.hpp"
+
+
+
+class BTreeSet : public Set<std::string>
+{
+public:
+    // The maximum number of keys in a node.
+    static constexpr unsigned int CAPACITY = 16;
+
+public:
+    // Initializes a BTreeSet to be empty.
+    BTreeSet();
+
+    // Cleans up the BTreeSet so that it leaks no memory.
+    virtual ~BTreeSet() noexcept;
+
+    // Initializes a new BTreeSet to be a copy of an existing one.
+    BTreeSet(const BTreeSet& s);
+
+    // Initializes a new BTreeSet whose contents are moved from an
+    // expiring one.
+    BTreeSet(BTreeSet&& s) noexcept;
+
+    // Assigns an existing BTreeSet into another.
+    BTreeSet& operator=(const BTreeSet& s);
+
+    // Assigns an expiring BTreeSet into another.
+    BTreeSet& operator=(BTreeSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It runs in O(log n) time.
+    virtual void add(const std::string& element) override;
+
+
+    // bulkLoad() adds the given elements to the set.  When the set is
+    // empty, it sorts them (unless they're sorted already) and builds the
+    // tree from the bottom up; otherwise, it adds them one at a time.
+    virtual void bulkLoad(const std::string* first, const std::string* last) override;
+
+
+    using Set<std::string>::contains;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It runs in O(log n) time.
+    virtual bool contains(const std::string& element) const override;
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // height() returns the number of levels of nodes below the root (so
+    // a tree that's a single leaf has height 0).  As with an AVLSet, the
+    // height of an empty tree is -1.
+    int height() const noexcept;
+
+
+    // Each of these calls visit(word) for a range of the words in the set,
+    // in ascending order, as std::string_views that are only valid during
+    // the call to visit:
+    //
+    //   * inorder() visits all of them
+    //   * visitRange() visits those that are at least "first" and less
+    //     than "last"
+    //   * visitPrefix() visits those that begin with the given prefix
+    template <typename VisitFunction>
+    void inorder(VisitFunction&& visit) const;
+
+    template <typename VisitFunction>
+    void visitRange(std::string_view first, std::string_view last, VisitFunction&& visit) const;
+
+    template <typename VisitFunction>
+    void visitPrefix(std::string_view prefix, VisitFunction&& visit) const;
+
+
+private:
+    // A fence is one of the separators on either side of a node in its
+    // parent, or none, at either end of the tree.
+    struct Fence
+    {
+        bool exists;
+        std::string_view key;
+    };
+
+    // fingerprints[i] is the fingerprint of keys[i] (with its sign bit
+    // flipped, so that fingerprints can be compared as signed integers,
+    // which is all that SSE2 can compare), for i < count; the rest are
+    // the largest fingerprint.  prefix_length is the number of characters
+    // that the node's fences have in common.
+    struct alignas(64) Node
+    {
+        std::int32_t fingerprints[CAPACITY];
+        unsigned char count;
+        unsigned char prefix_length;
+        bool is_leaf;
+        CompactString keys[CAPACITY];
+    };
+
+    // A Leaf holds words; next is the leaf holding the words after them.
+    struct Leaf : Node
+    {
+        Leaf* next;
+    };
+
+    // An Inner node holds count separators and count + 1 children; every
+    // word in the subtree of children[i] is at least keys[i - 1] and less
+    // than keys[i].
+    struct Inner : Node
+    {
+        Node* children[CAPACITY + 1];
+    };
+
+    Node* root;
+    unsigned int current_size;
+
+    static unsigned int lowerRank(const Node* node, std::string_view word) noexcept;
+    static unsigned int upperRank(const Node* node, std::string_view word) noexcept;
+    static unsigned int rank(const Node* node, std::string_view word, bool countEqual) noexcept;
+    static std::int32_t fingerprintOf(std::string_view word, unsigned int prefixLength) noexcept;
+
+    const Leaf* findLeaf(std::string_view word, unsigned int& position) const noexcept;
+    static void setFences(Node* node, Fence lower, Fence upper) noexcept;
+    static void setFingerprint(Node* node, unsigned int i) noexcept;
+
+    void splitChild(Inner* parent, unsigned int index, Fence lower, Fence upper);
+    static Leaf* newLeaf();
+    static Inner* newInner();
+
+    void build(const std::string* const* sorted, unsigned int count);
+    static void setAllFences(Node* node, Fence lower, Fence upper) noexcept;
+
+    static Node* copyTree(const Node* node, Leaf*& previous);
+    static void destroyTree(Node* node) noexcept;
+};
+
+
+
+template <typename VisitFunction>
+void BTreeSet::inorder(VisitFunction&& visit) const
+{
+    unsigned int position = 0;
+
+    for (const Leaf* leaf = findLeaf(std::string_view{}, position); leaf != nullptr; leaf = leaf->next)
+    {
+        for (unsigned int i = 0; i < leaf->count; ++i)
+        {
+            visit(leaf->keys[i].view());
+        }
+    }
+}
+
+
+template <typename VisitFunction>
+void BTreeSet::visitRange(std::string_view first, std::string_view last, VisitFunction&& visit) const
+{
+    unsigned int position = 0;
+
+    for (const Leaf* leaf = findLeaf(first, position); leaf != nullptr; leaf = leaf->next, position = 0)
+    {
+        for (unsigned int i = position; i < leaf->count; ++i)
+        {
+            std::string_view word = leaf->keys[i].view();
+
+            if (!(word < last))
+            {
+                return;
+            }
+
+            visit(word);
+        }
+    }
+}
+
+
+template <typename VisitFunction>
+void BTreeSet::visitPrefix(std::string_view prefix, VisitFunction&& visit) const
+{
+    unsigned int position = 0;
+
+    for (const Leaf* leaf = findLeaf(prefix, position); leaf != nullptr; leaf = leaf->next, position = 0)
+    {
+        for (unsigned int i = position; i < leaf->count; ++i)
+        {
+            std::string_view word = leaf->keys[i].view();
+
+            if (word.substr(0, prefix.size()) != prefix)
+            {
+                return;
+            }
+
+            visit(word);
+        }
+    }
+}
+
+
+
+#endif // BTREESET_HPP
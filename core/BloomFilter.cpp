@@ -0,0 +1,127 @@
+// BloomFilter.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cmath>
+#include "BloomFilter.hpp"
+#include "StringHashing.hpp"
+
+
+
+// The number of bits checked per word that minimizes the false positive
+// rate is the number of bits per word times ln 2.
+
+BloomFilter::BloomFilter(unsigned int bitsPerWord)
+    : bitsPerWord_{std::max(bitsPerWord, 1u)}, hashCount_{1}, wordCount{0}, built{false}
+{
+    hashCount_ = static_cast<unsigned int>(std::lround(bitsPerWord_ * std::log(2.0)));
+    hashCount_ = std::clamp(hashCount_, 1u, MAX_HASH_COUNT);
+}
+
+
+void BloomFilter::add(std::string_view word)
+{
+    pendingHashes.push_back(hashStringAsWy64(word));
+}
+
+
+void BloomFilter::build()
+{
+    wordCount = static_cast<unsigned int>(pendingHashes.size());
+
+    std::size_t bits = static_cast<std::size_t>(wordCount) * bitsPerWord_;
+    std::size_t blockCount = std::max<std::size_t>((bits + BITS_PER_BLOCK - 1) / BITS_PER_BLOCK, 1);
+
+    blocks.assign(blockCount, Block{});
+
+    for (std::uint64_t hash : pendingHashes)
+    {
+        Block& block = blocks[blockIndex(hash)];
+        std::uint32_t position = static_cast<std::uint32_t>(hash);
+        std::uint32_t step = static_cast<std::uint32_t>(hash >> 32) | 1;
+
+        for (unsigned int i = 0; i < hashCount_; ++i, position += step)
+        {
+            unsigned int bit = position % BITS_PER_BLOCK;
+            block.bits[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+
+    pendingHashes.clear();
+    pendingHashes.shrink_to_fit();
+    built = true;
+}
+
+
+bool BloomFilter::isBuilt() const noexcept
+{
+    return built;
+}
+
+
+bool BloomFilter::mightContain(std::string_view word) const noexcept
+{
+    if (!built)
+    {
+        return true;
+    }
+
+    std::uint64_t hash = hashStringAsWy64(word);
+    const Block& block = blocks[blockIndex(hash)];
+    std::uint32_t position = static_cast<std::uint32_t>(hash);
+    std::uint32_t step = static_cast<std::uint32_t>(hash >> 32) | 1;
+
+    for (unsigned int i = 0; i < hashCount_; ++i, position += step)
+    {
+        unsigned int bit = position % BITS_PER_BLOCK;
+
+        if ((block.bits[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+unsigned int BloomFilter::bitsPerWord() const noexcept
+{
+    return bitsPerWord_;
+}
+
+
+unsigned int BloomFilter::hashCount() const noexcept
+{
+    return hashCount_;
+}
+
+
+double BloomFilter::expectedFalsePositiveRate() const noexcept
+{
+    if (blocks.empty() || wordCount == 0)
+    {
+        return 0.0;
+    }
+
+    double bits = static_cast<double>(blocks.size()) * BITS_PER_BLOCK;
+    return std::pow(1.0 - std::exp(-(hashCount_ * (wordCount / bits))), hashCount_);
+}
+
+
+std::size_t BloomFilter::memoryUsage() const noexcept
+{
+    return blocks.size() * sizeof(Block);
+}
+
+
+// The upper half of the hash is scaled into the range of block indexes
+// by multiplying, rather than by dividing, so the number of blocks needn't
+// be a power of two.
+
+std::size_t BloomFilter::blockIndex(std::uint64_t hash) const noexcept
+{
+    return static_cast<std::size_t>(((hash >> 32) * blocks.size()) >> 32);
+}
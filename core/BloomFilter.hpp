@@ -0,0 +1,100 @@
+// BloomFilter.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BloomFilter is a compact summary of a list of words that can answer
+// "is this word certainly not in the list?" much more cheaply than the
+// list's Set can answer "is this word in the list?"  It never says that a
+// word in the list isn't there, but it sometimes (rarely, with enough bits
+// per word) fails to rule out one that isn't; those are false positives,
+// which the Set then has to reject.  Since nearly all of the candidates a
+// spell checker tries aren't words, most of them never reach the Set.
+//
+// The filter is "blocked": it's an array of 512-bit blocks, each the size
+// of a cache line, and all of the bits for a word are in the same block.
+// A word's 64-bit hash chooses its block with the upper half and, by
+// "double hashing" with both halves, the bits within the block, so a
+// lookup touches a single cache line no matter how many bits it checks.
+// That costs a slightly higher false positive rate than an ordinary Bloom
+// filter with the same number of bits, in exchange for far fewer cache
+// misses.
+//
+// Building the filter is done in two steps: add() each word, then build().
+
+#ifndef BLOOMFILTER_HPP
+#define BLOOMFILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+
+class BloomFilter
+{
+public:
+    // The number of bits per word when none is given.  Ten bits per word
+    // gives a false positive rate of roughly 1%.
+    static constexpr unsigned int DEFAULT_BITS_PER_WORD = 10;
+
+    // The most bits that are checked for each word.
+    static constexpr unsigned int MAX_HASH_COUNT = 16;
+
+public:
+    // Initializes a BloomFilter that will use (about) the given number of
+    // bits per word, which must be positive.
+    explicit BloomFilter(unsigned int bitsPerWord = DEFAULT_BITS_PER_WORD);
+
+    // add() adds a word to the filter.  It can't be called after build().
+    void add(std::string_view word);
+
+    // build() sizes the filter for the words that have been added and sets
+    // their bits.  Until it's been called, mightContain() rules nothing out.
+    void build();
+
+    // isBuilt() returns true if build() has been called.
+    bool isBuilt() const noexcept;
+
+    // mightContain() returns false if the given word is certainly not one
+    // of the words in the filter, true if it might be.
+    bool mightContain(std::string_view word) const noexcept;
+
+    // bitsPerWord() returns the number of bits per word the filter was
+    // given, and hashCount() the number of bits checked for each word.
+    unsigned int bitsPerWord() const noexcept;
+    unsigned int hashCount() const noexcept;
+
+    // expectedFalsePositiveRate() returns the rate of false positives an
+    // ordinary Bloom filter of the same size would have; a blocked one's
+    // is somewhat higher.
+    double expectedFalsePositiveRate() const noexcept;
+
+    // memoryUsage() returns the number of bytes occupied by the filter's
+    // blocks.
+    std::size_t memoryUsage() const noexcept;
+
+
+private:
+    static constexpr unsigned int BITS_PER_BLOCK = 512;
+
+    struct alignas(64) Block
+    {
+        std::uint64_t bits[BITS_PER_BLOCK / 64];
+    };
+
+    unsigned int bitsPerWord_;
+    unsigned int hashCount_;
+    unsigned int wordCount;
+    bool built;
+
+    std::vector<std::uint64_t> pendingHashes;
+    std::vector<Block> blocks;
+
+    std::size_t blockIndex(std::uint64_t hash) const noexcept;
+};
+
+
+
+#endif // BLOOMFILTER_HPP
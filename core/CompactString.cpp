@@ -0,0 +1,114 @@
+// CompactString.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <utility>
+#include "CompactString.hpp"
+
+
+
+CompactString::CompactString() noexcept
+{
+    bytes[0] = 0;
+}
+
+
+CompactString::CompactString(std::string_view s)
+{
+    assign(s);
+}
+
+
+CompactString::CompactString(const std::string& s)
+    : CompactString{std::string_view{s}}
+{
+}
+
+
+CompactString::CompactString(const char* s)
+    : CompactString{std::string_view{s}}
+{
+}
+
+
+CompactString::~CompactString() noexcept
+{
+    release();
+}
+
+
+CompactString::CompactString(const CompactString& s)
+{
+    assign(s.view());
+}
+
+
+CompactString::CompactString(CompactString&& s) noexcept
+{
+    std::memcpy(bytes, s.bytes, sizeof(bytes));
+    s.bytes[0] = 0;
+}
+
+
+CompactString& CompactString::operator=(const CompactString& s)
+{
+    if (this != &s)
+    {
+        CompactString copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+CompactString& CompactString::operator=(CompactString&& s) noexcept
+{
+    if (this != &s)
+    {
+        release();
+        std::memcpy(bytes, s.bytes, sizeof(bytes));
+        s.bytes[0] = 0;
+    }
+    return *this;
+}
+
+
+std::string CompactString::str() const
+{
+    return std::string{view()};
+}
+
+
+// assign() stores the given string, which the CompactString must not
+// already own any memory for.
+
+void CompactString::assign(std::string_view s)
+{
+    if (s.size() <= INLINE_CAPACITY)
+    {
+        bytes[0] = static_cast<unsigned char>(s.size());
+        s.copy(reinterpret_cast<char*>(bytes + 1), s.size());
+        return;
+    }
+
+    char* characters = new char[s.size()];
+    s.copy(characters, s.size());
+
+    std::size_t size = s.size();
+    bytes[0] = LONG_LENGTH;
+    std::memcpy(bytes + LONG_SIZE_OFFSET, &size, sizeof(size));
+    std::memcpy(bytes + LONG_POINTER_OFFSET, &characters, sizeof(characters));
+}
+
+
+void CompactString::release() noexcept
+{
+    if (!isInline())
+    {
+        char* characters;
+        std::memcpy(&characters, bytes + LONG_POINTER_OFFSET, sizeof(characters));
+        delete[] characters;
+        bytes[0] = 0;
+    }
+}
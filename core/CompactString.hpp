@@ -0,0 +1,146 @@
+// CompactString.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A CompactString is how HashSet and AVLSet store a std::string element in
+// their nodes.  It occupies 24 bytes, the first of which is its length,
+// and a string of up to INLINE_CAPACITY (23) characters is kept in the
+// rest of them, so comparing the element in a node with another string
+// only touches the node itself.  (A std::string occupies 32 bytes, and
+// libstdc++ only keeps up to 15 characters within it; longer ones are in a
+// separate allocation, which comparisons have to follow a pointer to.)
+//
+// A longer string is kept in a separate allocation of its own, in which
+// case the first byte is LONG_LENGTH, and the length and a pointer to the
+// characters follow it.  Very few words are that long.
+//
+// A CompactString can be compared with a std::string_view (and, so, with
+// a std::string) using the usual operators, which is all that the sets
+// need to do with their elements; view() and str() return its characters.
+//
+// NodeKey<ElementType> is the type in which a node stores an element:
+// CompactString for a std::string, and the ElementType itself otherwise.
+// elementOf<ElementType>() turns what a node stores back into an
+// ElementType (which, for anything but a CompactString, is the very same
+// object).
+
+#ifndef COMPACTSTRING_HPP
+#define COMPACTSTRING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+
+class CompactString
+{
+public:
+    static constexpr std::size_t INLINE_CAPACITY = 23;
+
+public:
+    CompactString() noexcept;
+    CompactString(std::string_view s);
+    CompactString(const std::string& s);
+    CompactString(const char* s);
+    ~CompactString() noexcept;
+
+    CompactString(const CompactString& s);
+    CompactString(CompactString&& s) noexcept;
+    CompactString& operator=(const CompactString& s);
+    CompactString& operator=(CompactString&& s) noexcept;
+
+    // size() returns the number of characters in the string, and
+    // isInline() returns true if they're stored within the CompactString.
+    std::size_t size() const noexcept;
+    bool isInline() const noexcept;
+
+    std::string_view view() const noexcept;
+    std::string str() const;
+
+private:
+    static constexpr unsigned char LONG_LENGTH = 0xFF;
+    static constexpr std::size_t LONG_SIZE_OFFSET = 8;
+    static constexpr std::size_t LONG_POINTER_OFFSET = 16;
+
+    // bytes[0] is the length (or LONG_LENGTH), and either the characters
+    // follow it or the length and the pointer are at the offsets above.
+    // They're copied in and out with std::memcpy(), which compilers turn
+    // into plain loads and stores.
+    alignas(char*) unsigned char bytes[INLINE_CAPACITY + 1];
+
+    void assign(std::string_view s);
+    void release() noexcept;
+};
+
+
+static_assert(sizeof(CompactString) == CompactString::INLINE_CAPACITY + 1);
+
+
+
+inline std::size_t CompactString::size() const noexcept
+{
+    return view().size();
+}
+
+
+inline bool CompactString::isInline() const noexcept
+{
+    return bytes[0] != LONG_LENGTH;
+}
+
+
+inline std::string_view CompactString::view() const noexcept
+{
+    if (isInline())
+    {
+        return std::string_view{reinterpret_cast<const char*>(bytes + 1), bytes[0]};
+    }
+
+    std::size_t size;
+    const char* characters;
+    std::memcpy(&size, bytes + LONG_SIZE_OFFSET, sizeof(size));
+    std::memcpy(&characters, bytes + LONG_POINTER_OFFSET, sizeof(characters));
+    return std::string_view{characters, size};
+}
+
+
+inline bool operator==(const CompactString& a, std::string_view b) noexcept { return a.view() == b; }
+inline bool operator!=(const CompactString& a, std::string_view b) noexcept { return a.view() != b; }
+inline bool operator<(const CompactString& a, std::string_view b) noexcept { return a.view() < b; }
+inline bool operator>(const CompactString& a, std::string_view b) noexcept { return a.view() > b; }
+inline bool operator<=(const CompactString& a, std::string_view b) noexcept { return a.view() <= b; }
+inline bool operator>=(const CompactString& a, std::string_view b) noexcept { return a.view() >= b; }
+
+inline bool operator==(std::string_view a, const CompactString& b) noexcept { return a == b.view(); }
+inline bool operator!=(std::string_view a, const CompactString& b) noexcept { return a != b.view(); }
+inline bool operator<(std::string_view a, const CompactString& b) noexcept { return a < b.view(); }
+inline bool operator>(std::string_view a, const CompactString& b) noexcept { return a > b.view(); }
+inline bool operator<=(std::string_view a, const CompactString& b) noexcept { return a <= b.view(); }
+inline bool operator>=(std::string_view a, const CompactString& b) noexcept { return a >= b.view(); }
+
+
+
+template <typename ElementType>
+using NodeKey = std::conditional_t<std::is_same_v<ElementType, std::string>, CompactString, ElementType>;
+
+
+template <typename ElementType>
+decltype(auto) elementOf(const NodeKey<ElementType>& key)
+{
+    if constexpr (std::is_same_v<NodeKey<ElementType>, ElementType>)
+    {
+        return (key);
+    }
+    else
+    {
+        return key.str();
+    }
+}
+
+
+
+#endif // COMPACTSTRING_HPP
@@ -0,0 +1,328 @@
+// CompiledWordSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "CompiledWordSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    constexpr char MAGIC[8] = {'I', 'C', 'S', '4', '6', 'W', 'R', 'D'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+
+    std::uint64_t alignUp(std::uint64_t n, std::uint64_t alignment) noexcept
+    {
+        return (n + alignment - 1) / alignment * alignment;
+    }
+
+
+    // The hash's low bits choose the bucket, while its high bits are kept
+    // in the bucket, so that most mismatches are ruled out without
+    // comparing strings.
+    std::uint32_t bucketHash(std::uint64_t hash) noexcept
+    {
+        return static_cast<std::uint32_t>(hash >> 32);
+    }
+
+
+    // sectionFits() returns true if a section of the given size, beginning
+    // at the given offset, lies within an image of the given size.
+    bool sectionFits(std::uint64_t start, std::uint64_t size, std::uint64_t imageSize) noexcept
+    {
+        return start <= imageSize && size <= imageSize - start;
+    }
+}
+
+
+
+CompiledWordSet::CompiledWordSet()
+    : wordCount{0}, bucketMask{0}, offsets{nullptr}, buckets{nullptr}, pool{nullptr}
+{
+    build(std::vector<std::string>{});
+}
+
+
+bool CompiledWordSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void CompiledWordSet::add(const std::string& /* element */)
+{
+    throw std::logic_error{"A CompiledWordSet can't be changed once it's built"};
+}
+
+
+void CompiledWordSet::bulkLoad(const std::string* first, const std::string* last)
+{
+    std::vector<std::string> words;
+    words.reserve(wordCount + static_cast<std::size_t>(last - first));
+
+    for (unsigned int i = 0; i < wordCount; ++i)
+    {
+        words.emplace_back(wordAt(i));
+    }
+
+    words.insert(words.end(), first, last);
+    build(std::move(words));
+}
+
+
+bool CompiledWordSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool CompiledWordSet::contains(std::string_view element) const
+{
+    if (wordCount == 0)
+    {
+        return false;
+    }
+
+    std::uint64_t hash = hashStringAsFnv1a64(element);
+    std::uint32_t tag = bucketHash(hash);
+
+    for (std::uint32_t i = static_cast<std::uint32_t>(hash) & bucketMask; ; i = (i + 1) & bucketMask)
+    {
+        const Bucket& bucket = buckets[i];
+
+        if (bucket.wordIndexPlusOne == 0)
+        {
+            return false;
+        }
+        else if (bucket.hash == tag && wordAt(bucket.wordIndexPlusOne - 1) == element)
+        {
+            return true;
+        }
+    }
+}
+
+
+unsigned int CompiledWordSet::size() const noexcept
+{
+    return wordCount;
+}
+
+
+bool CompiledWordSet::open(const std::string& imagePath)
+{
+    MappedFile newFile{imagePath};
+
+    if (!newFile.isOpen() || !attach(newFile.data(), newFile.size()))
+    {
+        return false;
+    }
+
+    file = std::move(newFile);
+    builtImage.clear();
+    builtImage.shrink_to_fit();
+    return true;
+}
+
+
+void CompiledWordSet::build(std::vector<std::string> words)
+{
+    std::vector<char> newImage = makeImage(std::move(words));
+
+    attach(newImage.data(), newImage.size());
+
+    builtImage = std::move(newImage);
+    file = MappedFile{};
+}
+
+
+std::string_view CompiledWordSet::wordAt(unsigned int index) const noexcept
+{
+    return std::string_view{pool + offsets[index], offsets[index + 1] - offsets[index]};
+}
+
+
+bool CompiledWordSet::isMapped() const noexcept
+{
+    return file.isMapped();
+}
+
+
+std::size_t CompiledWordSet::imageSize() const noexcept
+{
+    return file.isOpen() ? file.size() : builtImage.size();
+}
+
+
+bool CompiledWordSet::save(const std::string& imagePath) const
+{
+    const char* image = file.isOpen() ? file.data() : builtImage.data();
+
+    std::ofstream imageFile{imagePath, std::ios::binary | std::ios::trunc};
+    imageFile.write(image, static_cast<std::streamsize>(imageSize()));
+    imageFile.close();
+
+    return !imageFile.fail();
+}
+
+
+bool CompiledWordSet::isImage(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    char magic[sizeof(MAGIC)];
+
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+
+
+
+// attach() checks everything about the image that contains() and wordAt()
+// rely on -- that each section lies within the image, that the offsets
+// describe words within the pool, that the buckets refer to real words,
+// and that at least one bucket is empty (so that every search ends) --
+// before pointing the set at it.  It leaves the set unchanged and returns
+// false if any check fails.
+
+bool CompiledWordSet::attach(const char* image, std::size_t size) noexcept
+{
+    Header header;
+
+    if (size < sizeof(Header))
+    {
+        return false;
+    }
+
+    std::memcpy(&header, image, sizeof(Header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.byteOrder != BYTE_ORDER_MARK
+        || header.version != VERSION
+        || header.bucketCount == 0
+        || (header.bucketCount & (header.bucketCount - 1)) != 0
+        || header.bucketCount <= header.wordCount
+        || header.offsetsStart % alignof(std::uint32_t) != 0
+        || header.bucketsStart % alignof(Bucket) != 0
+        || !sectionFits(header.offsetsStart, (header.wordCount + std::uint64_t{1}) * sizeof(std::uint32_t), size)
+        || !sectionFits(header.bucketsStart, header.bucketCount * std::uint64_t{sizeof(Bucket)}, size)
+        || !sectionFits(header.poolStart, header.poolSize, size))
+    {
+        return false;
+    }
+
+    const std::uint32_t* newOffsets = reinterpret_cast<const std::uint32_t*>(image + header.offsetsStart);
+    const Bucket* newBuckets = reinterpret_cast<const Bucket*>(image + header.bucketsStart);
+
+    if (newOffsets[0] != 0 || newOffsets[header.wordCount] != header.poolSize)
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < header.wordCount; ++i)
+    {
+        if (newOffsets[i] > newOffsets[i + 1])
+        {
+            return false;
+        }
+    }
+
+    bool anyEmpty = false;
+
+    for (std::uint32_t i = 0; i < header.bucketCount; ++i)
+    {
+        if (newBuckets[i].wordIndexPlusOne > header.wordCount)
+        {
+            return false;
+        }
+
+        anyEmpty = anyEmpty || newBuckets[i].wordIndexPlusOne == 0;
+    }
+
+    if (!anyEmpty)
+    {
+        return false;
+    }
+
+    wordCount = header.wordCount;
+    bucketMask = header.bucketCount - 1;
+    offsets = newOffsets;
+    buckets = newBuckets;
+    pool = image + header.poolStart;
+    return true;
+}
+
+
+std::vector<char> CompiledWordSet::makeImage(std::vector<std::string> words)
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    std::uint64_t poolSize = 0;
+
+    for (const std::string& word : words)
+    {
+        poolSize += word.size();
+    }
+
+    if (words.size() >= std::numeric_limits<std::uint32_t>::max() / 2
+        || poolSize > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::length_error{"Too many words for a CompiledWordSet"};
+    }
+
+    std::uint32_t wordCount = static_cast<std::uint32_t>(words.size());
+    std::uint32_t bucketCount = 2;
+
+    while (bucketCount < wordCount * 2)
+    {
+        bucketCount *= 2;
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.wordCount = wordCount;
+    header.bucketCount = bucketCount;
+    header.offsetsStart = alignUp(sizeof(Header), alignof(std::uint64_t));
+    header.bucketsStart = alignUp(header.offsetsStart + (wordCount + std::uint64_t{1}) * sizeof(std::uint32_t), alignof(std::uint64_t));
+    header.poolStart = header.bucketsStart + bucketCount * std::uint64_t{sizeof(Bucket)};
+    header.poolSize = poolSize;
+
+    std::vector<char> image(header.poolStart + poolSize);
+    std::memcpy(image.data(), &header, sizeof(Header));
+
+    std::uint32_t* offsets = reinterpret_cast<std::uint32_t*>(image.data() + header.offsetsStart);
+    Bucket* buckets = reinterpret_cast<Bucket*>(image.data() + header.bucketsStart);
+    char* pool = image.data() + header.poolStart;
+
+    std::uint32_t offset = 0;
+
+    for (std::uint32_t i = 0; i < wordCount; ++i)
+    {
+        offsets[i] = offset;
+        std::memcpy(pool + offset, words[i].data(), words[i].size());
+        offset += static_cast<std::uint32_t>(words[i].size());
+
+        std::uint64_t hash = hashStringAsFnv1a64(words[i]);
+        std::uint32_t b = static_cast<std::uint32_t>(hash) & (bucketCount - 1);
+
+        while (buckets[b].wordIndexPlusOne != 0)
+        {
+            b = (b + 1) & (bucketCount - 1);
+        }
+
+        buckets[b] = Bucket{bucketHash(hash), i + 1};
+    }
+
+    offsets[wordCount] = offset;
+    return image;
+}
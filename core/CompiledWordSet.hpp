@@ -0,0 +1,153 @@
+// CompiledWordSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A CompiledWordSet is a read-only Set of strings stored in a compact
+// binary "image," which can be written to a file once and then mapped into
+// memory by any number of later runs, ready to be searched immediately: no
+// parsing, no converting to uppercase, and no adding words one at a time.
+//
+// An image is laid out like this (all integers are in the byte order of
+// the machine that wrote it, which is checked when it's opened):
+//
+//   * A Header, which identifies the file as an image and says where the
+//     other sections begin
+//   * The word offsets: wordCount + 1 32-bit offsets into the string pool,
+//     where word i begins at offsets[i] and ends at offsets[i + 1]
+//   * The hash index: bucketCount (a power of two) Buckets, each either
+//     empty or holding the hash of a word and its position in the offsets
+//     (plus one, so that zero means empty), found by linear probing from
+//     the bucket given by the word's 64-bit FNV-1a hash; at most half of
+//     the buckets are in use
+//   * The string pool: the words, in ascending order, one after another
+//
+// A CompiledWordSet can also be built in memory from a list of words, in
+// which case it holds the same image, just not in a file.  Either way, it
+// can't be changed one word at a time, so add() throws a std::logic_error;
+// bulkLoad() rebuilds it instead.
+
+#ifndef COMPILEDWORDSET_HPP
+#define COMPILEDWORDSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.hpp"
+#include "Set.hpp"
+
+
+
+class CompiledWordSet : public Set<std::string>
+{
+public:
+    // The version of the image format that this class reads and writes.
+    // Images of any other version are rejected.
+    static constexpr std::uint32_t VERSION = 1;
+
+public:
+    // Initializes a CompiledWordSet to be empty.
+    CompiledWordSet();
+
+    CompiledWordSet(const CompiledWordSet&) = delete;
+    CompiledWordSet& operator=(const CompiledWordSet&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // A CompiledWordSet can't be changed one word at a time, so add()
+    // throws a std::logic_error.
+    virtual void add(const std::string& element) override;
+
+
+    // bulkLoad() rebuilds the set from its current words and the given
+    // ones, which is the only way that a CompiledWordSet can grow.
+    virtual void bulkLoad(const std::string* first, const std::string* last) override;
+
+
+    using Set<std::string>::contains;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.
+    virtual bool contains(const std::string& element) const override;
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // open() replaces the contents of the set with the image in the given
+    // file, which is mapped into memory (or, where that's not possible,
+    // read into it).  It returns false, leaving the set unchanged, if the
+    // file can't be read or isn't a valid image of this VERSION.
+    bool open(const std::string& imagePath);
+
+    // build() replaces the contents of the set with the given words, which
+    // needn't be sorted and may contain duplicates.
+    void build(std::vector<std::string> words);
+
+    // wordAt() returns the word at the given position in ascending order,
+    // which must be less than size().
+    std::string_view wordAt(unsigned int index) const noexcept;
+
+    // isMapped() returns true if the image is mapped from a file, and
+    // imageSize() returns its size in bytes.
+    bool isMapped() const noexcept;
+    std::size_t imageSize() const noexcept;
+
+    // save() writes the set's image to the given file, so that it can be
+    // opened later, returning false if it couldn't be written.
+    bool save(const std::string& imagePath) const;
+
+
+    // isImage() returns true if the given file begins like an image (of
+    // any version), i.e., if it should be opened rather than read as a
+    // list of words.
+    static bool isImage(const std::string& path);
+
+
+
+private:
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t byteOrder;
+        std::uint32_t version;
+        std::uint32_t wordCount;
+        std::uint32_t bucketCount;
+        std::uint64_t offsetsStart;
+        std::uint64_t bucketsStart;
+        std::uint64_t poolStart;
+        std::uint64_t poolSize;
+    };
+
+    struct Bucket
+    {
+        std::uint32_t hash;
+        std::uint32_t wordIndexPlusOne;
+    };
+
+    // The image is either in a file (which is open) or was built in memory
+    // (in which case builtImage holds it); the other members point into it.
+    MappedFile file;
+    std::vector<char> builtImage;
+
+    unsigned int wordCount;
+    std::uint32_t bucketMask;
+    const std::uint32_t* offsets;
+    const Bucket* buckets;
+    const char* pool;
+
+    bool attach(const char* image, std::size_t size) noexcept;
+
+    static std::vector<char> makeImage(std::vector<std::string> words);
+};
+
+
+
+#endif // COMPILEDWORDSET_HPP
@@ -0,0 +1,445 @@
+// ConcurrentHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentHashSet is a separately-chained hash table that any number
+// of threads can search while one thread at a time adds elements to it, so
+// that a dictionary shared by many spell checking threads can have words
+// added to it while they run.
+//
+// Searching never waits for anything.  Nodes are never changed once
+// they're in a list; a new node is linked in at the front of its list,
+// fully built, with a single atomic store, so a search sees the list
+// either with it or without it, never halfway.  Adding, on the other hand,
+// takes a mutex, so that only one thread adds at a time.
+//
+// Resizing can't relink the existing nodes (as HashSet does), since a
+// search might be walking through them.  Instead, the elements are copied
+// into a new table, which then replaces the old one with another atomic
+// store.  Searches that start afterward use the new table, but the old one
+// can only be deleted once the searches that might still be using it have
+// finished.  That's done in the style of RCU ("read-copy-update"): each
+// search counts itself, while it runs, in one of two sets of counters,
+// chosen by the current "epoch"; after replacing the table, the adding
+// thread advances the epoch and waits for the count of searches in the
+// previous one to reach zero, twice over (so that searches which read the
+// epoch just before it advanced are waited for, too).  Each set of
+// counters is spread across several cache lines, chosen by thread, so
+// that searches on different threads don't all update the same one.
+//
+// Since resizing waits for searches to finish, it mustn't be done by a
+// thread that's in the middle of a search.  None of the members of this
+// class do that; it's only a concern if a search calls back into add().
+
+#ifndef CONCURRENTHASHSET_HPP
+#define CONCURRENTHASHSET_HPP
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentHashSet : public Set<ElementType>
+{
+public:
+    // The default capacity of the ConcurrentHashSet before anything has
+    // been added to it.
+    static constexpr unsigned int DEFAULT_CAPACITY = 10;
+
+    // The maximum ratio of size to capacity, beyond which the table is
+    // replaced with one twice as large.
+    static constexpr double MAX_LOAD_FACTOR = 0.8;
+
+    // The number of counters (each on its own cache line) in each of the
+    // two sets that count searches in progress.
+    static constexpr unsigned int READER_STRIPES = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+    // A LookupHashFunction is a function that takes a std::string_view and
+    // returns an unsigned int.  It must return the same value that the
+    // HashFunction would for an element with the same characters.
+    using LookupHashFunction = std::function<unsigned int(std::string_view)>;
+
+public:
+    // Initializes a ConcurrentHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.
+    explicit ConcurrentHashSet(HashFunction hashFunction);
+
+    // Initializes a ConcurrentHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element, and the
+    // given lookup hash function whenever contains() is asked about a
+    // std::string_view.
+    ConcurrentHashSet(HashFunction hashFunction, LookupHashFunction lookupHashFunction);
+
+    // Cleans up the ConcurrentHashSet so that it leaks no memory.  No
+    // other thread may be using it by then.
+    virtual ~ConcurrentHashSet() noexcept;
+
+    // A ConcurrentHashSet can be neither copied nor moved, since other
+    // threads may be using it.
+    ConcurrentHashSet(const ConcurrentHashSet&) = delete;
+    ConcurrentHashSet& operator=(const ConcurrentHashSet&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set, if it isn't already there.  It
+    // can be called by any thread, including while other threads are
+    // calling add() or contains(); the additions are done one at a time.
+    virtual void add(const ElementType& element) override;
+
+
+    // reserve() replaces the table, if necessary, with one large enough
+    // to hold the given number of elements without being replaced again.
+    virtual void reserve(unsigned int elementCount) override;
+
+
+    using Set<ElementType>::contains;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It can be called by any number of threads at once, and
+    // never waits for any of them (or for add()).  An element whose add()
+    // hasn't returned yet may or may not be found.
+    virtual bool contains(const ElementType& element) const override;
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // capacity() returns the size of the current table, and tablesRetired()
+    // the number of tables that have been replaced (and deleted).
+    unsigned int capacity() const noexcept;
+    unsigned int tablesRetired() const noexcept;
+
+
+private:
+    struct Node
+    {
+        ElementType value;
+        unsigned int hash;
+        Node* next;
+    };
+
+    struct Table
+    {
+        unsigned int capacity;
+        std::atomic<Node*>* lists;
+    };
+
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<long> count{0};
+    };
+
+    // A ReadGuard counts a search for as long as it exists.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const ConcurrentHashSet& set) noexcept;
+        ~ReadGuard() noexcept;
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::atomic<long>& count;
+    };
+
+    HashFunction hashFunction;
+    LookupHashFunction lookupHashFunction;
+
+    std::atomic<Table*> table;
+    std::atomic<unsigned int> current_size;
+    std::atomic<unsigned int> retired;
+    std::mutex writerMutex;
+
+    mutable std::atomic<unsigned int> epoch;
+    mutable ReaderCount readers[2][READER_STRIPES];
+
+    template <typename KeyType>
+    static bool containsInTable(const Table* t, unsigned int hash, const KeyType& element);
+
+    // replaceTable() copies the elements into a new table of the given
+    // capacity, which replaces the current one; the current one is then
+    // deleted once no search can be using it.  The writer mutex must be
+    // held.
+    void replaceTable(unsigned int newCapacity);
+
+    // waitForReaders() returns once every search that was in progress
+    // when it was called has finished.
+    void waitForReaders();
+
+    static Table* makeTable(unsigned int capacity);
+    static void destroyTable(Table* t) noexcept;
+
+    // readerStripe() returns the counter that the calling thread uses.
+    static unsigned int readerStripe() noexcept;
+};
+
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ReadGuard::ReadGuard(const ConcurrentHashSet& set) noexcept
+    : count{set.readers[set.epoch.load() & 1][readerStripe()].count}
+{
+    count.fetch_add(1);
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ReadGuard::~ReadGuard() noexcept
+{
+    count.fetch_sub(1);
+}
+
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(HashFunction hashFunction)
+    : ConcurrentHashSet{hashFunction, LookupHashFunction{}}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(
+    HashFunction hashFunction, LookupHashFunction lookupHashFunction)
+    : hashFunction{hashFunction}, lookupHashFunction{lookupHashFunction},
+      table{makeTable(DEFAULT_CAPACITY)}, current_size{0}, retired{0}, epoch{0}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::~ConcurrentHashSet() noexcept
+{
+    destroyTable(table.load());
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::add(const ElementType& element)
+{
+    std::lock_guard<std::mutex> lock{writerMutex};
+
+    unsigned int hash = hashFunction(element);
+
+    if (containsInTable(table.load(), hash, element))
+    {
+        return;
+    }
+
+    if (current_size.load() + 1 > table.load()->capacity * MAX_LOAD_FACTOR)
+    {
+        replaceTable(table.load()->capacity * 2);
+    }
+
+    // Only this thread changes the lists, so the node can be built with
+    // the current front of its list as its next node, then published.
+    Table* t = table.load();
+    std::atomic<Node*>& list = t->lists[hash % t->capacity];
+
+    list.store(new Node{element, hash, list.load(std::memory_order_relaxed)}, std::memory_order_release);
+    current_size.fetch_add(1);
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::reserve(unsigned int elementCount)
+{
+    std::lock_guard<std::mutex> lock{writerMutex};
+
+    unsigned int newCapacity = table.load()->capacity;
+
+    while (elementCount > newCapacity * MAX_LOAD_FACTOR)
+    {
+        newCapacity *= 2;
+    }
+
+    if (newCapacity != table.load()->capacity)
+    {
+        replaceTable(newCapacity);
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::contains(const ElementType& element) const
+{
+    unsigned int hash = hashFunction(element);
+
+    ReadGuard guard{*this};
+    return containsInTable(table.load(), hash, element);
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string>)
+    {
+        if (!lookupHashFunction)
+        {
+            return contains(ElementType{element});
+        }
+
+        unsigned int hash = lookupHashFunction(element);
+
+        ReadGuard guard{*this};
+        return containsInTable(table.load(), hash, element);
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
+    }
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::size() const noexcept
+{
+    return current_size.load();
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::capacity() const noexcept
+{
+    ReadGuard guard{*this};
+    return table.load()->capacity;
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::tablesRetired() const noexcept
+{
+    return retired.load();
+}
+
+
+template <typename ElementType>
+template <typename KeyType>
+bool ConcurrentHashSet<ElementType>::containsInTable(const Table* t, unsigned int hash, const KeyType& element)
+{
+    for (const Node* node = t->lists[hash % t->capacity].load(std::memory_order_acquire);
+         node != nullptr; node = node->next)
+    {
+        if (node->hash == hash && node->value == element)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::replaceTable(unsigned int newCapacity)
+{
+    Table* old = table.load();
+    Table* fresh = makeTable(newCapacity);
+
+    for (unsigned int i = 0; i < old->capacity; ++i)
+    {
+        for (const Node* node = old->lists[i].load(std::memory_order_relaxed); node != nullptr; node = node->next)
+        {
+            std::atomic<Node*>& list = fresh->lists[node->hash % newCapacity];
+            list.store(new Node{node->value, node->hash, list.load(std::memory_order_relaxed)}, std::memory_order_relaxed);
+        }
+    }
+
+    table.store(fresh);
+    waitForReaders();
+    destroyTable(old);
+
+    ++retired;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::waitForReaders()
+{
+    for (unsigned int phase = 0; phase < 2; ++phase)
+    {
+        unsigned int previous = epoch.fetch_add(1) & 1;
+
+        for (unsigned int stripe = 0; stripe < READER_STRIPES; ++stripe)
+        {
+            while (readers[previous][stripe].count.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+
+template <typename ElementType>
+typename ConcurrentHashSet<ElementType>::Table* ConcurrentHashSet<ElementType>::makeTable(unsigned int capacity)
+{
+    Table* t = new Table{capacity, new std::atomic<Node*>[capacity]};
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        t->lists[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    return t;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::destroyTable(Table* t) noexcept
+{
+    for (unsigned int i = 0; i < t->capacity; ++i)
+    {
+        Node* node = t->lists[i].load(std::memory_order_relaxed);
+
+        while (node != nullptr)
+        {
+            Node* temp = node;
+            node = node->next;
+            delete temp;
+        }
+    }
+
+    delete[] t->lists;
+    delete t;
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::readerStripe() noexcept
+{
+    static thread_local unsigned int stripe =
+        static_cast<unsigned int>(std::hash<std::thread::id>{}(std::this_thread::get_id()) % READER_STRIPES);
+
+    return stripe;
+}
+
+
+
+#endif // CONCURRENTHASHSET_HPP
@@ -0,0 +1,149 @@
+// EditCandidateGenerator.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <tuple>
+#include "EditCandidateGenerator.hpp"
+
+
+
+EditCandidateGenerator::EditCandidateGenerator(std::string_view alphabet)
+    : alphabet{alphabet}, buffer{inlineBuffer}, bufferSize{BUFFER_SIZE}
+{
+}
+
+
+EditCandidateGenerator::~EditCandidateGenerator() noexcept
+{
+    if (buffer != inlineBuffer)
+    {
+        delete[] buffer;
+    }
+}
+
+
+char* EditCandidateGenerator::bufferFor(std::size_t length)
+{
+    if (length > bufferSize)
+    {
+        char* newBuffer = new char[length];
+
+        if (buffer != inlineBuffer)
+        {
+            delete[] buffer;
+        }
+
+        buffer = newBuffer;
+        bufferSize = length;
+    }
+
+    return buffer;
+}
+
+
+bool CandidatePosition::operator<(const CandidatePosition& other) const noexcept
+{
+    return std::tie(kind, index, letter) < std::tie(other.kind, other.index, other.letter);
+}
+
+
+// locate() works out which edits could turn the word into the candidate from
+// the length of the prefix they have in common and the length of the suffix
+// they have in common.  An edit at index i is possible only if everything
+// before i is in the common prefix and everything after the edited part is
+// in the common suffix.
+
+bool EditCandidateGenerator::locate(
+    std::string_view word, std::string_view candidate, CandidatePosition& position) const
+{
+    std::size_t n = word.size();
+    std::size_t shorter = std::min(n, candidate.size());
+
+    std::size_t prefix = 0;
+
+    while (prefix < shorter && word[prefix] == candidate[prefix])
+    {
+        ++prefix;
+    }
+
+    std::size_t suffix = 0;
+
+    while (suffix < shorter && word[n - 1 - suffix] == candidate[candidate.size() - 1 - suffix])
+    {
+        ++suffix;
+    }
+
+    if (candidate.size() == n)
+    {
+        // A candidate equal to the word itself is reached by swapping two
+        // equal adjacent characters, or else by replacing a character with
+        // itself.
+        std::size_t i = prefix;
+
+        if (i == n)
+        {
+            for (i = 0; i + 1 < n && word[i] != word[i + 1]; ++i)
+            {
+            }
+
+            if (i + 1 < n)
+            {
+                position = CandidatePosition{EditKind::Swap, i, 0};
+                return true;
+            }
+
+            for (i = 0; i < n && alphabet.find(word[i]) == std::string_view::npos; ++i)
+            {
+            }
+
+            if (i < n)
+            {
+                position = CandidatePosition{EditKind::Replace, i, alphabet.find(word[i])};
+                return true;
+            }
+
+            return false;
+        }
+
+        if (i + 1 < n && candidate[i] == word[i + 1] && candidate[i + 1] == word[i] && n - (i + 2) <= suffix)
+        {
+            position = CandidatePosition{EditKind::Swap, i, 0};
+            return true;
+        }
+
+        std::size_t letter = alphabet.find(candidate[i]);
+
+        if (letter != std::string_view::npos && n - (i + 1) <= suffix)
+        {
+            position = CandidatePosition{EditKind::Replace, i, letter};
+            return true;
+        }
+    }
+    else if (candidate.size() == n + 1)
+    {
+        for (std::size_t i = n - std::min(n, suffix); i <= prefix; ++i)
+        {
+            std::size_t letter = alphabet.find(candidate[i]);
+
+            if (letter != std::string_view::npos)
+            {
+                position = CandidatePosition{EditKind::Insert, i, letter};
+                return true;
+            }
+        }
+    }
+    else if (candidate.size() + 1 == n)
+    {
+        std::size_t i = n - 1 - std::min(n - 1, suffix);
+
+        if (i <= prefix)
+        {
+            position = CandidatePosition{EditKind::Delete, i, 0};
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,278 @@
+// EditCandidateGenerator.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EditCandidateGenerator enumerates every word that is one edit away
+// from a given word, using the five kinds of edits that WordChecker bases
+// its suggestions on:
+//
+//   * swapping each pair of adjacent characters
+//   * inserting a letter of the alphabet before, between, or after the
+//     characters
+//   * deleting each character
+//   * replacing each character with a letter of the alphabet
+//   * splitting the word into two words with a space between them
+//
+// Rather than building a new string for each candidate, the generator
+// edits one buffer in place, moving from each candidate to the next with
+// a character or two of changes, and hands each candidate to a "visit"
+// function as a std::string_view into that buffer.  The view is only
+// valid during the call to the visit function.  A visit function can also
+// take a third argument, a CandidatePosition saying where in the word the
+// edit was made, which is useful for calculating something about each
+// candidate incrementally (such as its hash; see RollingHash).
+//
+// The buffer is an array inside the generator, so words of up to
+// BUFFER_SIZE - 1 characters involve no allocation at all; longer words
+// cause a larger buffer to be allocated and then reused for later words.
+
+#ifndef EDITCANDIDATEGENERATOR_HPP
+#define EDITCANDIDATEGENERATOR_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+
+enum class EditKind
+{
+    Swap,
+    Insert,
+    Delete,
+    Replace,
+    Split
+};
+
+
+
+// A CandidatePosition describes where a candidate first appears in the
+// order in which EditCandidateGenerator::generate() visits candidates: the
+// kind of edit, the index in the word at which it's made, and (for
+// insertions and replacements) the index of the letter in the alphabet.
+
+struct CandidatePosition
+{
+    EditKind kind;
+    std::size_t index;
+    std::size_t letter;
+
+    bool operator<(const CandidatePosition& other) const noexcept;
+};
+
+
+
+class EditCandidateGenerator
+{
+public:
+    // The size of the generator's built-in buffer.
+    static constexpr std::size_t BUFFER_SIZE = 64;
+
+public:
+    // Initializes a generator that inserts and replaces using the letters
+    // of the given alphabet.  The characters of the alphabet are not copied,
+    // so they need to outlive the generator (as a string literal does).
+    explicit EditCandidateGenerator(std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+
+    ~EditCandidateGenerator() noexcept;
+
+    EditCandidateGenerator(const EditCandidateGenerator&) = delete;
+    EditCandidateGenerator& operator=(const EditCandidateGenerator&) = delete;
+
+
+    // generate() calls visit(kind, candidate) for every candidate, doing
+    // all of the swaps, then the insertions, deletions, replacements, and
+    // finally the splits.  For EditKind::Split, the candidate is the two
+    // halves separated by a single space.
+    template <typename VisitFunction>
+    void generate(std::string_view word, VisitFunction&& visit);
+
+    // Each of these generates the candidates for one kind of edit.
+    template <typename VisitFunction>
+    void generateSwaps(std::string_view word, VisitFunction&& visit);
+
+    template <typename VisitFunction>
+    void generateInsertions(std::string_view word, VisitFunction&& visit);
+
+    template <typename VisitFunction>
+    void generateDeletions(std::string_view word, VisitFunction&& visit);
+
+    template <typename VisitFunction>
+    void generateReplacements(std::string_view word, VisitFunction&& visit);
+
+    template <typename VisitFunction>
+    void generateSplits(std::string_view word, VisitFunction&& visit);
+
+
+    // locate() determines whether the given candidate is one that generate()
+    // would visit for the given word, other than a split.  If so, it stores
+    // the position at which it would first be visited into position and
+    // returns true; otherwise, it returns false.  This runs in time linear
+    // in the length of the word.
+    bool locate(std::string_view word, std::string_view candidate, CandidatePosition& position) const;
+
+
+private:
+    std::string_view alphabet;
+
+    char inlineBuffer[BUFFER_SIZE];
+    char* buffer;
+    std::size_t bufferSize;
+
+    // bufferFor() returns a buffer holding at least the given number
+    // of characters.
+    char* bufferFor(std::size_t length);
+
+    // visitCandidate() calls visit(kind, candidate), or, if the visit
+    // function takes one, visit(kind, candidate, position).
+    template <typename VisitFunction>
+    static void visitCandidate(
+        VisitFunction& visit, EditKind kind, std::string_view candidate,
+        std::size_t index, std::size_t letter);
+};
+
+
+
+template <typename VisitFunction>
+void EditCandidateGenerator::visitCandidate(
+    VisitFunction& visit, EditKind kind, std::string_view candidate,
+    std::size_t index, std::size_t letter)
+{
+    if constexpr (std::is_invocable_v<VisitFunction&, EditKind, std::string_view, const CandidatePosition&>)
+    {
+        visit(kind, candidate, CandidatePosition{kind, index, letter});
+    }
+    else
+    {
+        visit(kind, candidate);
+    }
+}
+
+
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generate(std::string_view word, VisitFunction&& visit)
+{
+    generateSwaps(word, visit);
+    generateInsertions(word, visit);
+    generateDeletions(word, visit);
+    generateReplacements(word, visit);
+    generateSplits(word, visit);
+}
+
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generateSwaps(std::string_view word, VisitFunction&& visit)
+{
+    char* candidate = bufferFor(word.size());
+    word.copy(candidate, word.size());
+
+    for (std::size_t i = 0; i + 1 < word.size(); ++i)
+    {
+        std::swap(candidate[i], candidate[i + 1]);
+        visitCandidate(visit, EditKind::Swap, std::string_view{candidate, word.size()}, i, 0);
+        std::swap(candidate[i], candidate[i + 1]);
+    }
+}
+
+
+// The insertion candidate starts with a "hole" at index 0 followed by the
+// word; after each position is tried, the hole moves one place right.
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generateInsertions(std::string_view word, VisitFunction&& visit)
+{
+    char* candidate = bufferFor(word.size() + 1);
+    word.copy(candidate + 1, word.size());
+
+    for (std::size_t i = 0; i <= word.size(); ++i)
+    {
+        for (std::size_t letter = 0; letter < alphabet.size(); ++letter)
+        {
+            candidate[i] = alphabet[letter];
+            visitCandidate(visit, EditKind::Insert, std::string_view{candidate, word.size() + 1}, i, letter);
+        }
+
+        if (i < word.size())
+        {
+            candidate[i] = word[i];
+        }
+    }
+}
+
+
+// The deletion candidate starts as the word without its first character;
+// after each position is tried, the deleted position moves one place right.
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generateDeletions(std::string_view word, VisitFunction&& visit)
+{
+    if (word.empty())
+    {
+        return;
+    }
+
+    char* candidate = bufferFor(word.size() - 1);
+    word.copy(candidate, word.size() - 1, 1);
+
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        visitCandidate(visit, EditKind::Delete, std::string_view{candidate, word.size() - 1}, i, 0);
+
+        if (i + 1 < word.size())
+        {
+            candidate[i] = word[i];
+        }
+    }
+}
+
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generateReplacements(std::string_view word, VisitFunction&& visit)
+{
+    char* candidate = bufferFor(word.size());
+    word.copy(candidate, word.size());
+
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        for (std::size_t letter = 0; letter < alphabet.size(); ++letter)
+        {
+            candidate[i] = alphabet[letter];
+            visitCandidate(visit, EditKind::Replace, std::string_view{candidate, word.size()}, i, letter);
+        }
+
+        candidate[i] = word[i];
+    }
+}
+
+
+// The split candidate starts as the first character, a space, and the rest
+// of the word; after each position is tried, the space moves one place right.
+
+template <typename VisitFunction>
+void EditCandidateGenerator::generateSplits(std::string_view word, VisitFunction&& visit)
+{
+    if (word.size() < 2)
+    {
+        return;
+    }
+
+    char* candidate = bufferFor(word.size() + 1);
+    candidate[0] = word[0];
+    candidate[1] = ' ';
+    word.copy(candidate + 2, word.size() - 1, 1);
+
+    for (std::size_t i = 1; i < word.size(); ++i)
+    {
+        visitCandidate(visit, EditKind::Split, std::string_view{candidate, word.size() + 1}, i, 0);
+
+        candidate[i] = word[i];
+        candidate[i + 1] = ' ';
+    }
+}
+
+
+
+#endif // EDITCANDIDATEGENERATOR_HPP
@@ -0,0 +1,554 @@
+// EytzingerSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EytzingerSet is a read-optimized Set that keeps its elements in sorted
+// order, like an AVLSet, but without any nodes or pointers.  The elements
+// are laid out in a single array in the order that a breadth-first
+// traversal of a perfectly balanced binary search tree would visit them
+// (the "Eytzinger" layout, which is how a binary heap is stored): the root
+// is at index 1, and the children of the element at index k are at indexes
+// 2k and 2k + 1.  Searching walks down the implicit tree, but each step
+// computes the next index arithmetically rather than loading a pointer,
+// so the loop has no unpredictable branches, and since the next several
+// levels' indexes are known ahead of time, the memory they're in can be
+// prefetched while the current comparison is being made.  The first few
+// levels, which every search visits, share the same few cache lines.
+//
+// For a set of strings, each element's first 8 characters are also kept,
+// packed into an integer (with the first character in the most significant
+// byte, so that comparing two of them compares their characters in
+// order), in a separate array in the same order.  The search compares the
+// integers, and only looks at the strings themselves when their first 8
+// characters are the same, so most steps of a search touch 8 bytes rather
+// than a std::string and the characters it points to.
+//
+// The array is built from sorted elements, which is what bulkLoad() does,
+// in linear time for elements that are sorted already.  add() works, but
+// has to rebuild the whole array, so it takes linear time; an EytzingerSet
+// is meant to be loaded all at once and then only searched.
+//
+// inorder() visits the elements in sorted order, as AVLSet's does.
+
+#ifndef EYTZINGERSET_HPP
+#define EYTZINGERSET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class EytzingerSet : public Set<ElementType>
+{
+public:
+    // A VisitFunction is a function that takes a reference to a const
+    // ElementType and returns no value.
+    using VisitFunction = std::function<void(const ElementType&)>;
+
+    // The number of levels below the current one whose memory a search
+    // prefetches.  The 2^PREFETCH_LEVELS elements that many levels down
+    // are next to each other in the array.
+    static constexpr unsigned int PREFETCH_LEVELS = 4;
+
+public:
+    // Initializes an EytzingerSet to be empty.
+    EytzingerSet();
+
+    // Cleans up the EytzingerSet so that it leaks no memory.
+    virtual ~EytzingerSet() noexcept;
+
+    // Initializes a new EytzingerSet to be a copy of an existing one.
+    EytzingerSet(const EytzingerSet& s);
+
+    // Initializes a new EytzingerSet whose contents are moved from an
+    // expiring one.
+    EytzingerSet(EytzingerSet&& s) noexcept;
+
+    // Assigns an existing EytzingerSet into another.
+    EytzingerSet& operator=(const EytzingerSet& s);
+
+    // Assigns an expiring EytzingerSet into another.
+    EytzingerSet& operator=(EytzingerSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set, rebuilding the array, which takes
+    // linear time.  If the element is already in the set, this function
+    // has no effect (and takes logarithmic time).
+    virtual void add(const ElementType& element) override;
+
+
+    // bulkLoad() rebuilds the array from the current elements and the
+    // given ones, which needn't be sorted and may contain duplicates.  It
+    // takes linear time if they're sorted, O(n log n) otherwise.
+    virtual void bulkLoad(const ElementType* first, const ElementType* last) override;
+
+
+    using Set<ElementType>::contains;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It takes O(log n) time, with one comparison per level.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // contains() can also be asked about a std::string_view; when the
+    // elements are strings, it's compared against them directly, so no
+    // std::string is constructed.
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // height() returns the height of the implicit tree.  As with an
+    // AVLSet, the height of an empty tree is -1.
+    int height() const noexcept;
+
+
+    // inorder() calls the given "visit" function for each of the elements
+    // in the set, in sorted order.
+    void inorder(VisitFunction visit) const;
+
+
+private:
+    static constexpr bool hasPrefixes = std::is_same_v<ElementType, std::string>;
+
+    // elements[1] through elements[current_size] hold the elements in
+    // Eytzinger order (elements[0] is unused), and prefixes[k] holds the
+    // packed first characters of elements[k] when the elements are
+    // strings; otherwise, prefixes is nullptr.
+    ElementType* elements;
+    std::uint64_t* prefixes;
+    std::size_t current_size;
+
+    template <typename KeyType>
+    std::size_t lowerBound(const KeyType& element) const noexcept;
+    template <typename KeyType>
+    bool isLess(std::size_t k, std::uint64_t prefix, const KeyType& element) const noexcept;
+
+    void rebuild(const ElementType* const* sorted, std::size_t count);
+    void fill(const ElementType* const* sorted, std::size_t& next, std::size_t k);
+    void inorderHelper(std::size_t k, VisitFunction& visit) const;
+    void destroy() noexcept;
+
+    static std::uint64_t prefixOf(std::string_view element) noexcept;
+};
+
+
+
+namespace impl_
+{
+    inline void EytzingerSet__prefetch(const void* address) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#endif
+    }
+
+
+    // EytzingerSet__trailingOnes() returns the number of 1 bits at the
+    // low end of k, which is never all 1 bits.
+
+    inline unsigned int EytzingerSet__trailingOnes(std::size_t k) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctzll(~static_cast<unsigned long long>(k)));
+#else
+        unsigned int count = 0;
+
+        for (; (k & 1) != 0; k >>= 1)
+        {
+            ++count;
+        }
+
+        return count;
+#endif
+    }
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::EytzingerSet()
+    : elements{nullptr}, prefixes{nullptr}, current_size{0}
+{
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::~EytzingerSet() noexcept
+{
+    destroy();
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::EytzingerSet(const EytzingerSet& s)
+    : elements{nullptr}, prefixes{nullptr}, current_size{0}
+{
+    if (s.current_size == 0)
+    {
+        return;
+    }
+
+    elements = new ElementType[s.current_size + 1];
+
+    try
+    {
+        std::copy(s.elements + 1, s.elements + s.current_size + 1, elements + 1);
+
+        if (s.prefixes != nullptr)
+        {
+            prefixes = new std::uint64_t[s.current_size + 1];
+            std::copy(s.prefixes, s.prefixes + s.current_size + 1, prefixes);
+        }
+    }
+    catch (...)
+    {
+        destroy();
+        throw;
+    }
+
+    current_size = s.current_size;
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::EytzingerSet(EytzingerSet&& s) noexcept
+    : elements{nullptr}, prefixes{nullptr}, current_size{0}
+{
+    std::swap(elements, s.elements);
+    std::swap(prefixes, s.prefixes);
+    std::swap(current_size, s.current_size);
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>& EytzingerSet<ElementType>::operator=(const EytzingerSet& s)
+{
+    if (this != &s)
+    {
+        EytzingerSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>& EytzingerSet<ElementType>::operator=(EytzingerSet&& s) noexcept
+{
+    std::swap(elements, s.elements);
+    std::swap(prefixes, s.prefixes);
+    std::swap(current_size, s.current_size);
+    return *this;
+}
+
+
+template <typename ElementType>
+bool EytzingerSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::add(const ElementType& element)
+{
+    if (!contains(element))
+    {
+        bulkLoad(&element, &element + 1);
+    }
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::bulkLoad(const ElementType* first, const ElementType* last)
+{
+    std::size_t added = static_cast<std::size_t>(last - first);
+
+    if (added == 0)
+    {
+        return;
+    }
+
+    // The current elements are gathered in sorted order (which is the
+    // order of an inorder traversal), followed by the new ones.
+    std::size_t count = current_size + added;
+    const ElementType** sorted = new const ElementType*[count];
+    std::size_t next = 0;
+
+    try
+    {
+        inorder(
+            [&](const ElementType& element)
+            {
+                sorted[next++] = &element;
+            });
+
+        for (; first != last; ++first)
+        {
+            sorted[next++] = first;
+        }
+
+        auto isLessThan = [](const ElementType* a, const ElementType* b) { return *a < *b; };
+
+        if (!std::is_sorted(sorted, sorted + count, isLessThan))
+        {
+            std::sort(sorted, sorted + count, isLessThan);
+        }
+
+        std::size_t unique = 0;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (unique == 0 || *sorted[unique - 1] < *sorted[i])
+            {
+                sorted[unique++] = sorted[i];
+            }
+        }
+
+        rebuild(sorted, unique);
+    }
+    catch (...)
+    {
+        delete[] sorted;
+        throw;
+    }
+
+    delete[] sorted;
+}
+
+
+template <typename ElementType>
+bool EytzingerSet<ElementType>::contains(const ElementType& element) const
+{
+    std::size_t k = lowerBound(element);
+    return k != 0 && elements[k] == element;
+}
+
+
+template <typename ElementType>
+bool EytzingerSet<ElementType>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string>)
+    {
+        std::size_t k = lowerBound(element);
+        return k != 0 && elements[k] == element;
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
+    }
+}
+
+
+template <typename ElementType>
+unsigned int EytzingerSet<ElementType>::size() const noexcept
+{
+    return static_cast<unsigned int>(current_size);
+}
+
+
+template <typename ElementType>
+int EytzingerSet<ElementType>::height() const noexcept
+{
+    int height = -1;
+
+    for (std::size_t k = current_size; k != 0; k >>= 1)
+    {
+        ++height;
+    }
+
+    return height;
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::inorder(VisitFunction visit) const
+{
+    inorderHelper(1, visit);
+}
+
+
+// lowerBound() returns the index of the smallest element that isn't less
+// than the given one, or 0 if they're all less than it.
+//
+// Each step goes to the left child (2k) if the element at k isn't less
+// than the given one and to the right child (2k + 1) if it is, so once the
+// search falls off the bottom of the tree, the bits of k record the turns
+// it took.  The element being searched for is the last one at which it
+// turned left; undoing the right turns after that (the trailing 1 bits)
+// and the left turn itself finds its index.
+
+template <typename ElementType>
+template <typename KeyType>
+std::size_t EytzingerSet<ElementType>::lowerBound(const KeyType& element) const noexcept
+{
+    std::uint64_t prefix = 0;
+
+    if constexpr (hasPrefixes)
+    {
+        prefix = prefixOf(element);
+    }
+
+    std::size_t k = 1;
+
+    while (k <= current_size)
+    {
+        // The descendants PREFETCH_LEVELS levels down are next to each
+        // other, starting at this index.  Near the bottom of the tree,
+        // there are none, which is the only time this branch goes the
+        // other way.
+        std::size_t ahead = k << PREFETCH_LEVELS;
+
+        if (ahead <= current_size)
+        {
+            if constexpr (hasPrefixes)
+            {
+                impl_::EytzingerSet__prefetch(prefixes + ahead);
+            }
+            else
+            {
+                impl_::EytzingerSet__prefetch(elements + ahead);
+            }
+        }
+
+        k = 2 * k + (isLess(k, prefix, element) ? 1 : 0);
+    }
+
+    return k >> (impl_::EytzingerSet__trailingOnes(k) + 1);
+}
+
+
+// isLess() returns true if the element at index k is less than the given
+// one.  For strings, the packed prefixes decide unless they're equal.
+
+template <typename ElementType>
+template <typename KeyType>
+bool EytzingerSet<ElementType>::isLess(std::size_t k, std::uint64_t prefix, const KeyType& element) const noexcept
+{
+    if constexpr (hasPrefixes)
+    {
+        std::uint64_t other = prefixes[k];
+
+        if (other != prefix)
+        {
+            return other < prefix;
+        }
+
+        return std::string_view{elements[k]} < std::string_view{element};
+    }
+    else
+    {
+        return elements[k] < element;
+    }
+}
+
+
+// rebuild() replaces the array with one built from the given sorted,
+// distinct elements.
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::rebuild(const ElementType* const* sorted, std::size_t count)
+{
+    EytzingerSet built;
+    built.elements = new ElementType[count + 1];
+    built.current_size = count;
+
+    std::size_t next = 0;
+    built.fill(sorted, next, 1);
+
+    if constexpr (hasPrefixes)
+    {
+        built.prefixes = new std::uint64_t[count + 1];
+        built.prefixes[0] = 0;
+
+        for (std::size_t k = 1; k <= count; ++k)
+        {
+            built.prefixes[k] = prefixOf(built.elements[k]);
+        }
+    }
+
+    *this = std::move(built);
+}
+
+
+// fill() copies the sorted elements, in order, into the subtree rooted at
+// index k by filling its left subtree, then k itself, then its right
+// subtree, which is an inorder traversal.
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::fill(const ElementType* const* sorted, std::size_t& next, std::size_t k)
+{
+    if (k <= current_size)
+    {
+        fill(sorted, next, 2 * k);
+        elements[k] = *sorted[next++];
+        fill(sorted, next, 2 * k + 1);
+    }
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::inorderHelper(std::size_t k, VisitFunction& visit) const
+{
+    if (k <= current_size)
+    {
+        inorderHelper(2 * k, visit);
+        visit(elements[k]);
+        inorderHelper(2 * k + 1, visit);
+    }
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::destroy() noexcept
+{
+    delete[] elements;
+    delete[] prefixes;
+    elements = nullptr;
+    prefixes = nullptr;
+    current_size = 0;
+}
+
+
+// prefixOf() packs the first 8 characters of the string (or all of them,
+// followed by zeroes, if it's shorter) into an integer, the first in the
+// most significant byte.  Characters are compared as unsigned chars, as
+// std::string compares them.
+
+template <typename ElementType>
+std::uint64_t EytzingerSet<ElementType>::prefixOf(std::string_view element) noexcept
+{
+    std::uint64_t prefix = 0;
+    std::size_t length = std::min(element.size(), std::size_t{8});
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        prefix <<= 8;
+
+        if (i < length)
+        {
+            prefix |= static_cast<unsigned char>(element[i]);
+        }
+    }
+
+    return prefix;
+}
+
+
+
+#endif // EYTZINGERSET_HPP
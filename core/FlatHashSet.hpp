@@ -0,0 +1,521 @@
+// FlatHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A FlatHashSet is an implementation of a Set that is an open-addressing
+// hash table in the style of a "Swiss table."  Rather than keeping a
+// linked list per bucket, elements are stored directly in one array of
+// slots, alongside a parallel array of one-byte "control" tags.  The
+// control array is divided into groups of 16 tags; a tag is either
+// "empty" or holds the low 7 bits of the hash of the element in the
+// corresponding slot.
+//
+// A lookup hashes the element once, uses the high bits to choose a
+// starting group and the low 7 bits as the tag, and then compares the
+// tag against all 16 control bytes of the group at once (using SSE2
+// instructions when they're available, or a plain loop otherwise).
+// Only the slots whose tags match are actually compared, so a typical
+// lookup touches one group of control bytes and one slot.  If the group
+// has no match and contains an empty tag, the element is not in the set;
+// otherwise, the search moves on to another group (quadratically, by
+// group).
+//
+// The table always has a power-of-two number of slots and is doubled
+// when the ratio of size to capacity would exceed 7/8.
+
+#ifndef FLATHASHSET_HPP
+#define FLATHASHSET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Set.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+template <typename ElementType>
+class FlatHashSet : public Set<ElementType>
+{
+public:
+    // The number of control bytes examined together during a lookup.
+    static constexpr unsigned int GROUP_WIDTH = 16;
+
+    // The default capacity of the FlatHashSet before anything has been
+    // added to it.  This is always a multiple of GROUP_WIDTH.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+    // A LookupHashFunction is a function that takes a std::string_view and
+    // returns an unsigned int.  It must return the same value that the
+    // HashFunction would for an element with the same characters.
+    using LookupHashFunction = std::function<unsigned int(std::string_view)>;
+
+public:
+    // Initializes a FlatHashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element.
+    explicit FlatHashSet(HashFunction hashFunction);
+
+    // Initializes a FlatHashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element, and the given
+    // lookup hash function whenever contains() is asked about a
+    // std::string_view.
+    FlatHashSet(HashFunction hashFunction, LookupHashFunction lookupHashFunction);
+
+    // Cleans up the FlatHashSet so that it leaks no memory.
+    virtual ~FlatHashSet() noexcept;
+
+    // Initializes a new FlatHashSet to be a copy of an existing one.
+    FlatHashSet(const FlatHashSet& s);
+
+    // Initializes a new FlatHashSet whose contents are moved from an
+    // expiring one.
+    FlatHashSet(FlatHashSet&& s) noexcept;
+
+    // Assigns an existing FlatHashSet into another.
+    FlatHashSet& operator=(const FlatHashSet& s);
+
+    // Assigns an expiring FlatHashSet into another.
+    FlatHashSet& operator=(FlatHashSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  This function doubles the capacity when
+    // the ratio of size to capacity would exceed 7/8, in which case it runs
+    // in linear time; otherwise, it runs in constant time (assuming a good
+    // hash function).
+    virtual void add(const ElementType& element) override;
+
+
+    // bulkLoad() reserves room for all of the given elements before adding
+    // any of them.
+    virtual void bulkLoad(const ElementType* first, const ElementType* last) override;
+
+
+    // reserve() doubles the capacity (as many times as necessary, but only
+    // moving the elements once) until the given number of elements would
+    // fit without the ratio of size to capacity exceeding 7/8.
+    virtual void reserve(unsigned int elementCount) override;
+
+
+    using Set<ElementType>::contains;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (assuming a good
+    // hash function).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // contains() can also be asked about a std::string_view.  If a lookup
+    // hash function was given to the constructor, the view is hashed and
+    // compared in place; otherwise, it's copied into an ElementType first.
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // capacity() returns the number of slots in the table.
+    unsigned int capacity() const noexcept;
+
+
+private:
+    // A control byte is either EMPTY (high bit set) or a 7-bit tag taken
+    // from the hash of the element in the corresponding slot.
+    static constexpr signed char EMPTY = -128;
+
+    HashFunction hashFunction;
+    LookupHashFunction lookupHashFunction;
+    signed char* control;
+    ElementType* slots;
+    unsigned int max_capacity;
+    unsigned int current_size;
+
+    static std::uint64_t mixedHash(unsigned int hash) noexcept;
+
+    template <typename KeyType>
+    unsigned int findSlot(const KeyType& element, std::uint64_t hash) const;
+    unsigned int findEmptySlot(std::uint64_t hash) const;
+    void insertAt(unsigned int slot, std::uint64_t hash, ElementType&& element);
+    void resize(unsigned int new_capacity);
+
+    static unsigned int matchTag(const signed char* group, signed char tag) noexcept;
+    static unsigned int matchEmpty(const signed char* group) noexcept;
+    static unsigned int lowestBit(unsigned int mask) noexcept;
+};
+
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction},
+      control{new signed char[DEFAULT_CAPACITY]},
+      slots{new ElementType[DEFAULT_CAPACITY]},
+      max_capacity{DEFAULT_CAPACITY}, current_size{0}
+{
+    std::fill(control, control + max_capacity, EMPTY);
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(HashFunction hashFunction, LookupHashFunction lookupHashFunction)
+    : FlatHashSet{hashFunction}
+{
+    this->lookupHashFunction = lookupHashFunction;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::~FlatHashSet() noexcept
+{
+    delete[] control;
+    delete[] slots;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(const FlatHashSet& s)
+    : hashFunction{s.hashFunction}, lookupHashFunction{s.lookupHashFunction},
+      control{new signed char[s.max_capacity]},
+      slots{nullptr},
+      max_capacity{s.max_capacity}, current_size{s.current_size}
+{
+    try
+    {
+        slots = new ElementType[max_capacity];
+        std::copy(s.control, s.control + max_capacity, control);
+        std::copy(s.slots, s.slots + max_capacity, slots);
+    }
+    catch (...)
+    {
+        delete[] control;
+        delete[] slots;
+        throw;
+    }
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(FlatHashSet&& s) noexcept
+    : FlatHashSet{s.hashFunction, s.lookupHashFunction}
+{
+    std::swap(control, s.control);
+    std::swap(slots, s.slots);
+    std::swap(max_capacity, s.max_capacity);
+    std::swap(current_size, s.current_size);
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(const FlatHashSet& s)
+{
+    if (this != &s)
+    {
+        FlatHashSet copy{s};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(FlatHashSet&& s) noexcept
+{
+    if (this != &s)
+    {
+        std::swap(hashFunction, s.hashFunction);
+        std::swap(lookupHashFunction, s.lookupHashFunction);
+        std::swap(control, s.control);
+        std::swap(slots, s.slots);
+        std::swap(max_capacity, s.max_capacity);
+        std::swap(current_size, s.current_size);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::add(const ElementType& element)
+{
+    std::uint64_t hash = mixedHash(hashFunction(element));
+
+    if (findSlot(element, hash) != max_capacity)
+    {
+        return;
+    }
+
+    if (static_cast<std::uint64_t>(current_size + 1) * 8 > static_cast<std::uint64_t>(max_capacity) * 7)
+    {
+        resize(max_capacity * 2);
+    }
+
+    insertAt(findEmptySlot(hash), hash, ElementType{element});
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::bulkLoad(const ElementType* first, const ElementType* last)
+{
+    reserve(static_cast<unsigned int>(current_size + (last - first)));
+
+    for (; first != last; ++first)
+    {
+        add(*first);
+    }
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::reserve(unsigned int elementCount)
+{
+    unsigned int new_capacity = max_capacity;
+
+    while (static_cast<std::uint64_t>(elementCount) * 8 > static_cast<std::uint64_t>(new_capacity) * 7)
+    {
+        new_capacity *= 2;
+    }
+
+    if (new_capacity != max_capacity)
+    {
+        resize(new_capacity);
+    }
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::contains(const ElementType& element) const
+{
+    return findSlot(element, mixedHash(hashFunction(element))) != max_capacity;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string>)
+    {
+        if (!lookupHashFunction)
+        {
+            return contains(ElementType{element});
+        }
+
+        return findSlot(element, mixedHash(lookupHashFunction(element))) != max_capacity;
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
+    }
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::size() const noexcept
+{
+    return current_size;
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::capacity() const noexcept
+{
+    return max_capacity;
+}
+
+
+// The provided hash functions are 32-bit and tend to leave their high bits
+// poorly distributed for short inputs, so the hash is spread across 64 bits
+// (by multiplying with a large odd constant) before it's split into a group
+// index and a tag.
+
+template <typename ElementType>
+std::uint64_t FlatHashSet<ElementType>::mixedHash(unsigned int hash) noexcept
+{
+    std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+    return mixed ^ (mixed >> 32);
+}
+
+
+// findSlot() returns the index of the slot holding the given element, or
+// max_capacity if the element is not in the table.
+
+template <typename ElementType>
+template <typename KeyType>
+unsigned int FlatHashSet<ElementType>::findSlot(const KeyType& element, std::uint64_t hash) const
+{
+    unsigned int group_mask = max_capacity / GROUP_WIDTH - 1;
+    unsigned int group = static_cast<unsigned int>(hash >> 7) & group_mask;
+    signed char tag = static_cast<signed char>(hash & 0x7F);
+
+    for (unsigned int step = 1; ; ++step)
+    {
+        const signed char* group_control = control + group * GROUP_WIDTH;
+
+        for (unsigned int matches = matchTag(group_control, tag); matches != 0; matches &= matches - 1)
+        {
+            unsigned int slot = group * GROUP_WIDTH + lowestBit(matches);
+
+            if (slots[slot] == element)
+            {
+                return slot;
+            }
+        }
+
+        if (matchEmpty(group_control) != 0)
+        {
+            return max_capacity;
+        }
+
+        group = (group + step) & group_mask;
+    }
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::findEmptySlot(std::uint64_t hash) const
+{
+    unsigned int group_mask = max_capacity / GROUP_WIDTH - 1;
+    unsigned int group = static_cast<unsigned int>(hash >> 7) & group_mask;
+
+    for (unsigned int step = 1; ; ++step)
+    {
+        unsigned int empties = matchEmpty(control + group * GROUP_WIDTH);
+
+        if (empties != 0)
+        {
+            return group * GROUP_WIDTH + lowestBit(empties);
+        }
+
+        group = (group + step) & group_mask;
+    }
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::insertAt(unsigned int slot, std::uint64_t hash, ElementType&& element)
+{
+    slots[slot] = std::move(element);
+    control[slot] = static_cast<signed char>(hash & 0x7F);
+    current_size++;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::resize(unsigned int new_capacity)
+{
+    signed char* old_control = control;
+    ElementType* old_slots = slots;
+    unsigned int old_capacity = max_capacity;
+
+    ElementType* new_slots = new ElementType[new_capacity];
+    control = new signed char[new_capacity];
+    slots = new_slots;
+    max_capacity = new_capacity;
+    current_size = 0;
+
+    std::fill(control, control + max_capacity, EMPTY);
+
+    for (unsigned int i = 0; i < old_capacity; ++i)
+    {
+        if (old_control[i] != EMPTY)
+        {
+            std::uint64_t hash = mixedHash(hashFunction(old_slots[i]));
+            insertAt(findEmptySlot(hash), hash, std::move(old_slots[i]));
+        }
+    }
+
+    delete[] old_control;
+    delete[] old_slots;
+}
+
+
+// matchTag() returns a bitmask with bit i set whenever the i-th control
+// byte in the group is equal to the given tag.
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::matchTag(const signed char* group, signed char tag) noexcept
+{
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(tag))));
+#else
+    unsigned int mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        mask |= static_cast<unsigned int>(group[i] == tag) << i;
+    }
+
+    return mask;
+#endif
+}
+
+
+// matchEmpty() returns a bitmask with bit i set whenever the i-th control
+// byte in the group is EMPTY.  Since EMPTY is the only control value with
+// its high bit set, SSE2 can pull the mask out directly.
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::matchEmpty(const signed char* group) noexcept
+{
+#ifdef __SSE2__
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<unsigned int>(_mm_movemask_epi8(bytes));
+#else
+    unsigned int mask = 0;
+
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        mask |= static_cast<unsigned int>(group[i] == EMPTY) << i;
+    }
+
+    return mask;
+#endif
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::lowestBit(unsigned int mask) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+    unsigned int index = 0;
+
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+
+
+#endif // FLATHASHSET_HPP
@@ -0,0 +1,328 @@
+// FrozenHashSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include "FrozenHashSet.hpp"
+#include "StringHashing.hpp"
+
+
+
+namespace
+{
+    // A bucket that still can't be placed after this many pilots makes the
+    // build start over with another seed.  With n words, the last few
+    // buckets each have only a handful of free slots to land in, so they
+    // can take on the order of n pilots; this limit is far beyond that, but
+    // it keeps a run of bad luck from going on forever.
+    constexpr std::uint32_t MAX_PILOT = 1u << 30;
+
+
+    // mix64() is the finalizer of the "splitmix64" generator, which spreads
+    // every bit of its input across all 64 bits of its output.
+    std::uint64_t mix64(std::uint64_t z) noexcept
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+
+    // mixPilot() spreads the bits of a pilot across 64 bits, so that
+    // consecutive pilots are unrelated to one another.
+    std::uint64_t mixPilot(std::uint32_t pilot) noexcept
+    {
+        return mix64(pilot + 0x9e3779b97f4a7c15ull);
+    }
+
+
+    // scale() maps a 64-bit value onto the range [0, n) by multiplying,
+    // which is much faster than dividing and works for any n.
+    std::uint32_t scale(std::uint64_t value, std::uint32_t n) noexcept
+    {
+        return static_cast<std::uint32_t>((static_cast<unsigned __int128>(value) * n) >> 64);
+    }
+}
+
+
+
+FrozenHashSet::FrozenHashSet()
+    : wordCount{0}, seed{0}, attempts{0}, pilots(1, 0), offsets(1, 0)
+{
+}
+
+
+bool FrozenHashSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void FrozenHashSet::add(const std::string& /* element */)
+{
+    throw std::logic_error{"A FrozenHashSet can't be changed once it's built"};
+}
+
+
+void FrozenHashSet::bulkLoad(const std::string* first, const std::string* last)
+{
+    std::vector<std::string> words;
+    words.reserve(wordCount + static_cast<std::size_t>(last - first));
+
+    for (unsigned int slot = 0; slot < wordCount; ++slot)
+    {
+        words.emplace_back(wordAt(slot));
+    }
+
+    words.insert(words.end(), first, last);
+    build(std::move(words));
+}
+
+
+bool FrozenHashSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool FrozenHashSet::contains(std::string_view element) const
+{
+    if (wordCount == 0)
+    {
+        return false;
+    }
+
+    std::uint64_t hash = hashStringAsWy64(element, seed);
+    std::uint32_t slot = slotOf(hash, pilots[bucketOf(hash)]);
+
+    std::uint32_t start = offsets[slot];
+
+    return offsets[slot + 1] - start == element.size()
+        && std::memcmp(pool.data() + start, element.data(), element.size()) == 0;
+}
+
+
+unsigned int FrozenHashSet::size() const noexcept
+{
+    return wordCount;
+}
+
+
+void FrozenHashSet::build(std::vector<std::string> words)
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    wordCount = static_cast<unsigned int>(words.size());
+    attempts = 0;
+
+    std::vector<std::uint32_t> slots;
+
+    do
+    {
+        seed = attempts++;
+    }
+    while (!tryBuild(words, slots));
+
+    // The words are laid out in the pool in the order of their slots.
+    std::vector<std::uint32_t> wordInSlot(wordCount);
+
+    for (std::uint32_t i = 0; i < wordCount; ++i)
+    {
+        wordInSlot[slots[i]] = i;
+    }
+
+    std::size_t poolSize = 0;
+
+    for (const std::string& word : words)
+    {
+        poolSize += word.size();
+    }
+
+    pool.clear();
+    pool.reserve(poolSize);
+    offsets.assign(1, 0);
+    offsets.reserve(wordCount + 1);
+
+    for (std::uint32_t slot = 0; slot < wordCount; ++slot)
+    {
+        pool.append(words[wordInSlot[slot]]);
+        offsets.push_back(static_cast<std::uint32_t>(pool.size()));
+    }
+}
+
+
+std::string_view FrozenHashSet::wordAt(unsigned int slot) const noexcept
+{
+    return std::string_view{pool.data() + offsets[slot], offsets[slot + 1] - offsets[slot]};
+}
+
+
+unsigned int FrozenHashSet::bucketCount() const noexcept
+{
+    return static_cast<unsigned int>(pilots.size());
+}
+
+
+unsigned int FrozenHashSet::buildAttempts() const noexcept
+{
+    return attempts;
+}
+
+
+std::size_t FrozenHashSet::memoryUsage() const noexcept
+{
+    return pilots.size() * sizeof(std::uint32_t)
+        + offsets.size() * sizeof(std::uint32_t)
+        + pool.size();
+}
+
+
+// The low half of the hash chooses the bucket, while the pilot is mixed
+// into the whole hash to choose the slot.  Since scale() only looks at
+// the top bits of its value, the hash and pilot are mixed again after
+// they're combined; otherwise, the words' top bits would differ in the
+// same way whatever the pilot, and every pilot would send them to
+// roughly the same slots.
+
+std::uint32_t FrozenHashSet::bucketOf(std::uint64_t hash) const noexcept
+{
+    return scale(hash << 32, static_cast<std::uint32_t>(pilots.size()));
+}
+
+
+std::uint32_t FrozenHashSet::slotOf(std::uint64_t hash, std::uint32_t pilot) const noexcept
+{
+    return scale(mix64(hash ^ mixPilot(pilot)), wordCount);
+}
+
+
+bool FrozenHashSet::tryBuild(const std::vector<std::string>& words, std::vector<std::uint32_t>& slots)
+{
+    std::uint32_t bucketTotal = std::max<std::uint32_t>((wordCount + AVERAGE_BUCKET_SIZE - 1) / AVERAGE_BUCKET_SIZE, 1);
+    pilots.assign(bucketTotal, 0);
+
+    std::vector<std::uint64_t> hashes(wordCount);
+
+    for (std::uint32_t i = 0; i < wordCount; ++i)
+    {
+        hashes[i] = hashStringAsWy64(words[i], seed);
+    }
+
+    // The words are grouped by bucket with a counting sort, so that the
+    // words in bucket b are bucketWords[bucketStarts[b]] up to (but not
+    // including) bucketWords[bucketStarts[b + 1]].
+    std::vector<std::uint32_t> bucketStarts(bucketTotal + 1, 0);
+
+    for (std::uint64_t hash : hashes)
+    {
+        ++bucketStarts[bucketOf(hash) + 1];
+    }
+
+    std::uint32_t largest = 0;
+
+    for (std::uint32_t b = 0; b < bucketTotal; ++b)
+    {
+        largest = std::max(largest, bucketStarts[b + 1]);
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+
+    std::vector<std::uint32_t> bucketWords(wordCount);
+    std::vector<std::uint32_t> next(bucketStarts.begin(), bucketStarts.end() - 1);
+
+    for (std::uint32_t i = 0; i < wordCount; ++i)
+    {
+        bucketWords[next[bucketOf(hashes[i])]++] = i;
+    }
+
+    // The buckets are then ordered from largest to smallest, with another
+    // counting sort (by size, this time).
+    std::vector<std::uint32_t> sizeStarts(largest + 2, 0);
+
+    for (std::uint32_t b = 0; b < bucketTotal; ++b)
+    {
+        ++sizeStarts[largest - (bucketStarts[b + 1] - bucketStarts[b]) + 1];
+    }
+
+    for (std::uint32_t size = 0; size <= largest; ++size)
+    {
+        sizeStarts[size + 1] += sizeStarts[size];
+    }
+
+    std::vector<std::uint32_t> order(bucketTotal);
+
+    for (std::uint32_t b = 0; b < bucketTotal; ++b)
+    {
+        order[sizeStarts[largest - (bucketStarts[b + 1] - bucketStarts[b])]++] = b;
+    }
+
+    std::vector<bool> taken(wordCount, false);
+    std::vector<std::uint32_t> tried(largest);
+    slots.assign(wordCount, 0);
+
+    for (std::uint32_t b : order)
+    {
+        const std::uint32_t* first = bucketWords.data() + bucketStarts[b];
+        std::uint32_t count = bucketStarts[b + 1] - bucketStarts[b];
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            for (std::uint32_t j = 0; j < i; ++j)
+            {
+                if (hashes[first[i]] == hashes[first[j]])
+                {
+                    return false;
+                }
+            }
+        }
+
+        std::uint32_t pilot = 0;
+
+        for (; pilot < MAX_PILOT; ++pilot)
+        {
+            std::uint64_t mixed = mixPilot(pilot);
+            std::uint32_t placed = 0;
+
+            for (; placed < count; ++placed)
+            {
+                std::uint32_t slot = scale(mix64(hashes[first[placed]] ^ mixed), wordCount);
+
+                if (taken[slot] || std::find(tried.begin(), tried.begin() + placed, slot) != tried.begin() + placed)
+                {
+                    break;
+                }
+
+                tried[placed] = slot;
+            }
+
+            if (placed == count)
+            {
+                break;
+            }
+        }
+
+        if (pilot == MAX_PILOT)
+        {
+            return false;
+        }
+
+        pilots[b] = pilot;
+
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            taken[tried[i]] = true;
+            slots[first[i]] = tried[i];
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,122 @@
+// FrozenHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A FrozenHashSet is a read-only Set of strings for a dictionary that never
+// changes once it's loaded.  It's built all at once from a finished list of
+// words, using a "minimal perfect hash" function: one that maps each of the
+// n words to a different slot numbered 0 through n - 1, so there are no
+// collisions to resolve, and no empty slots.  The words are stored in slot
+// order in a single string pool, so contains() hashes the string, reads
+// one slot, and compares the string with the one word in it.
+//
+// The hash function is built in the style of CHD and PTHash.  Each word's
+// 64-bit hash puts it into one of a smaller number of buckets (about
+// AVERAGE_BUCKET_SIZE words per bucket), and each bucket is assigned a
+// "pilot": a number that's mixed with the hashes of the bucket's words to
+// choose their slots.  The buckets are given pilots from largest to
+// smallest, trying 0, 1, 2, ... until one sends all of the bucket's words
+// to slots that are still free.  Large buckets are placed while most slots
+// are free, and by the time the table is nearly full, the buckets left
+// have just a word or two each.  If two words ever share a 64-bit hash (so
+// no pilot could separate them), or a bucket can't be placed within a
+// generous limit on its pilot, the whole thing is started over with
+// another seed for the hash.
+//
+// Since the set can't be changed one word at a time, add() throws a
+// std::logic_error; bulkLoad() rebuilds it from its current words and the
+// given ones instead.
+
+#ifndef FROZENHASHSET_HPP
+#define FROZENHASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Set.hpp"
+
+
+
+class FrozenHashSet : public Set<std::string>
+{
+public:
+    // The average number of words per bucket.  More words per bucket means
+    // fewer pilots to store, but more tries to find each of them.
+    static constexpr unsigned int AVERAGE_BUCKET_SIZE = 4;
+
+public:
+    // Initializes a FrozenHashSet to be empty.
+    FrozenHashSet();
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // A FrozenHashSet can't be changed one word at a time, so add() throws
+    // a std::logic_error.
+    virtual void add(const std::string& element) override;
+
+
+    // bulkLoad() rebuilds the set from its current words and the given
+    // ones, which is the only way that a FrozenHashSet can grow.
+    virtual void bulkLoad(const std::string* first, const std::string* last) override;
+
+
+    using Set<std::string>::contains;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It makes exactly one probe and at most one comparison.
+    virtual bool contains(const std::string& element) const override;
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // build() replaces the contents of the set with the given words, which
+    // needn't be sorted and may contain duplicates.
+    void build(std::vector<std::string> words);
+
+    // wordAt() returns the word in the given slot, which must be less than
+    // size().
+    std::string_view wordAt(unsigned int slot) const noexcept;
+
+    // bucketCount() returns the number of buckets (and, so, pilots), and
+    // buildAttempts() the number of seeds that were tried before one
+    // worked (almost always 1).
+    unsigned int bucketCount() const noexcept;
+    unsigned int buildAttempts() const noexcept;
+
+    // memoryUsage() returns the number of bytes occupied by the pilots,
+    // the offsets of the words, and the string pool.
+    std::size_t memoryUsage() const noexcept;
+
+
+private:
+    unsigned int wordCount;
+    std::uint64_t seed;
+    unsigned int attempts;
+
+    // pilots[b] is the pilot of bucket b, while the word in slot s is the
+    // characters of pool from offsets[s] up to offsets[s + 1].
+    std::vector<std::uint32_t> pilots;
+    std::vector<std::uint32_t> offsets;
+    std::string pool;
+
+    std::uint32_t bucketOf(std::uint64_t hash) const noexcept;
+    std::uint32_t slotOf(std::uint64_t hash, std::uint32_t pilot) const noexcept;
+
+    // tryBuild() tries to build the perfect hash function for the given
+    // (distinct) words using the given seed, storing the slot of each word
+    // into slots.  It returns false if two of the words' hashes are equal.
+    bool tryBuild(const std::vector<std::string>& words, std::vector<std::uint32_t>& slots);
+};
+
+
+
+#endif // FROZENHASHSET_HPP
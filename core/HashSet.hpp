@@ -12,7 +12,44 @@
 // As elements are added to the HashSet and the proportion of the HashSet's
 // size to its capacity exceeds 0.8 (i.e., there are more than 80% as many
 // elements as there are array cells), the HashSet should be resized so
-// that it is twice as large as it was before.
+// that it is twice as large as it was before.  (The 0.8 is the default
+// maximum load factor; a different one can be given to the constructor.)
+// When the number of elements is known ahead of time, reserve() makes room
+// for all of them at once, so that no resizing is necessary.
+//
+// Resizing moves the existing nodes into the new array, rather than
+// allocating new ones.  Ordinarily, they're all moved by the call to add()
+// that triggers the resizing, so that one call takes time proportional to
+// the size of the set.  In the Incremental resize mode, that call only
+// allocates the new array; each later call to add() moves the nodes in a
+// few of the old array's lists (MIGRATION_STEP of them), and, until they've
+// all been moved, lookups search the list in the old array as well as the
+// one in the new array.  No single add() then moves more than a few lists'
+// worth of nodes.  (contains() never moves nodes, so it's still safe for
+// several threads to look up elements at the same time.)
+//
+// How elements are hashed is decided by the HashPolicy.  By default, it's a
+// FunctionHashPolicy, in which case the hash function is a std::function
+// passed to the constructor.  Alternatively, the HashPolicy can be a type
+// whose objects can be called to hash an element (and, for a set of
+// strings, a std::string_view), such as ProductHashPolicy in
+// StringHashing.hpp.  Since the hash function is then known at compile
+// time, calls to it can be inlined, rather than made indirectly through a
+// std::function.
+//
+// Where the nodes are allocated is decided by the NodeAllocator (see
+// NodeAllocator.hpp).  By default, each is allocated separately with new;
+// with an ArenaNodeAllocator, they're allocated together in large blocks,
+// which are freed all at once when the HashSet is destroyed.
+//
+// Each node also keeps the full hash of its element, so resizing never
+// needs to call the hash function again, and searching a list compares
+// the element with only those nodes whose hashes match; since most of the
+// words a spell checker looks up aren't in the set, most searches compare
+// no elements at all.  nodesSearched() and elementComparisons() measure
+// the difference.  A set of strings stores each one in its node as a
+// CompactString (see CompactString.hpp), which keeps the characters of
+// most words within the node itself.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
@@ -23,12 +60,38 @@
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <functional>
+#include <initializer_list>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "CompactString.hpp"
+#include "NodeAllocator.hpp"
 #include "Set.hpp"
 
 
 
+// A FunctionHashPolicy is the HashPolicy that a HashSet uses unless it's
+// given another one.  Rather than hashing elements itself, it holds the
+// hash functions passed to the HashSet's constructor and calls them.
+
 template <typename ElementType>
+struct FunctionHashPolicy
+{
+    std::function<unsigned int(const ElementType&)> hashFunction;
+    std::function<unsigned int(std::string_view)> lookupHashFunction;
+};
+
+
+
+template <
+    typename ElementType, typename HashPolicy = FunctionHashPolicy<ElementType>,
+    template <typename> class NodeAllocator = HeapNodeAllocator>
 class HashSet : public Set<ElementType>
 {
 public:
@@ -36,14 +99,55 @@ public:
     // added to it.
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+    // The default maximum ratio of size to capacity, beyond which the
+    // array is resized.
+    static constexpr double DEFAULT_MAX_LOAD_FACTOR = 0.8;
+
     // A HashFunction is a function that takes a reference to a const
     // ElementType and returns an unsigned int.
     using HashFunction = std::function<unsigned int(const ElementType&)>;
 
+    // A LookupHashFunction is a function that takes a std::string_view and
+    // returns an unsigned int.  It must return the same value that the
+    // HashFunction would for an element with the same characters.
+    using LookupHashFunction = std::function<unsigned int(std::string_view)>;
+
+    // A ResizeMode decides whether the nodes are moved into a resized array
+    // all at once or a few lists at a time.
+    enum class ResizeMode
+    {
+        AllAtOnce,
+        Incremental
+    };
+
+    // The number of the old array's lists whose nodes are moved by each
+    // call to add() while an incremental resizing is in progress.
+    static constexpr unsigned int MIGRATION_STEP = 4;
+
 public:
+    // Initializes a HashSet to be empty, so that it will use its
+    // HashPolicy to hash elements.  The array is resized whenever the
+    // ratio of size to capacity would exceed the given maximum load
+    // factor, which must be positive.  (This constructor can't be used
+    // with a FunctionHashPolicy, since there would be no hash function.)
+    explicit HashSet(double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR);
+
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
-    explicit HashSet(HashFunction hashFunction);
+    // hash function whenever it needs to hash an element.  The array is
+    // resized whenever the ratio of size to capacity would exceed the
+    // given maximum load factor, which must be positive.
+    explicit HashSet(
+        HashFunction hashFunction,
+        double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR);
+
+    // Initializes a HashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element, and the given
+    // lookup hash function whenever contains() is asked about a
+    // std::string_view.  (These two constructors can only be used with a
+    // FunctionHashPolicy.)
+    HashSet(
+        HashFunction hashFunction, LookupHashFunction lookupHashFunction,
+        double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR);
 
     // Cleans up the HashSet so that it leaks no memory.
     virtual ~HashSet() noexcept;
@@ -69,27 +173,81 @@ public:
 
     // add() adds an element to the set.  If the element is already in the set,
     // this function has no effect.  This function triggers a resizing of the
-    // array when the ratio of size to capacity would exceed 0.8.  In the case
+    // array when the ratio of size to capacity would exceed 0.8 (or the
+    // maximum load factor given to the constructor).  In the case
     // where the array is resized, this function runs in linear time (with
     // respect to the number of elements, assuming a good hash function);
     // otherwise, it runs in constant time (again, assuming a good hash
     // function).
+    // In the Incremental resize mode, it always runs in constant time,
+    // apart from allocating the new array when a resizing begins.
     virtual void add(const ElementType& element) override;
 
 
+    // bulkLoad() reserves room for all of the given elements before adding
+    // any of them, so that none of the additions triggers a resizing.
+    virtual void bulkLoad(const ElementType* first, const ElementType* last) override;
+
+
+    // reserve() resizes the array, if necessary, so that the set can hold
+    // the given number of elements without exceeding its maximum load
+    // factor (and, so, without any further resizing).
+    virtual void reserve(unsigned int elementCount) override;
+
+
+    using Set<ElementType>::contains;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in constant time (with respect
     // to the number of elements, assuming a good hash function).
     virtual bool contains(const ElementType& element) const override;
 
 
+    // contains() can also be asked about a std::string_view.  If a lookup
+    // hash function was given to the constructor (or the HashPolicy can
+    // hash a std::string_view), the view is hashed and compared in place;
+    // otherwise, it's copied into an ElementType first.
+    virtual bool contains(std::string_view element) const override;
+
+
+    // If the HashPolicy is a rolling hash (i.e., it has a ROLLING_HASH_BASE,
+    // as ProductHashPolicy does), rollingHashBase() returns its base, and
+    // containsHashed() searches the list for the given hash without
+    // hashing the element again.
+    virtual unsigned int rollingHashBase() const noexcept override;
+    virtual bool containsHashed(unsigned int hash, std::string_view element) const override;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
 
+    // capacity() returns the number of cells in the array, and
+    // maxLoadFactor() returns the maximum ratio of size to capacity.
+    // While an incremental resizing is in progress, capacity() is the
+    // capacity of the new array.
+    unsigned int capacity() const noexcept;
+    double maxLoadFactor() const noexcept;
+
+
+    // setResizeMode() decides how the array is resized from now on; the
+    // default is ResizeMode::AllAtOnce.  Switching back to AllAtOnce
+    // finishes any incremental resizing that's in progress.
+    void setResizeMode(ResizeMode mode);
+    ResizeMode resizeMode() const noexcept;
+
+
+    // isResizing() returns true if an incremental resizing is in progress
+    // (i.e., some nodes are still in the old array).
+    bool isResizing() const noexcept;
+
+
     // elementsAtIndex() returns the number of elements that hashed to a
     // particular index in the array.  If the index is out of the boundaries
-    // of the array, this function returns 0.
+    // of the array, this function returns 0.  (While an incremental
+    // resizing is in progress, this and isElementAtIndex() also count the
+    // elements that will hash to the index once they've been moved.)
     unsigned int elementsAtIndex(unsigned int index) const;
 
 
@@ -99,22 +257,62 @@ public:
     bool isElementAtIndex(const ElementType& element, unsigned int index) const;
 
 
+    // nodesSearched() returns the number of nodes that contains() visits
+    // when asked about the given element: every node in the list at its
+    // index, if it's not in the set, or the nodes up to and including the
+    // one holding it, if it is.  While an incremental resizing is in
+    // progress, this includes the nodes in the old array's list, which is
+    // searched after the new one's.
+    unsigned int nodesSearched(const ElementType& element) const;
+
+
+    // elementComparisons() returns how many of the nodes that contains()
+    // visits it actually compares the given element against, which is only
+    // the ones whose hashes match the element's.  (Without cached hashes,
+    // this would be the same as nodesSearched().)
+    unsigned int elementComparisons(const ElementType& element) const;
+
+
 
 private:
+    static constexpr bool usesHashFunctions =
+        std::is_same_v<HashPolicy, FunctionHashPolicy<ElementType>>;
+
     struct Node
     {
-        ElementType value;
+        NodeKey<ElementType> value;
+        unsigned int hash;
         Node* next;
     };
 
-    HashFunction hashFunction;
+    HashPolicy policy;
+    NodeAllocator<Node> nodes;
     Node** hash_set;
     int max_capacity;
     int current_size;
-
-    void copyHashSet(Node** const &source, Node** target, const unsigned int max_size) const;
-    void initializeHashSet(Node** hs, const unsigned int max_size) const;
-    void addToHashSet(Node* &first_pointer, Node* &old_node) const;
+    double max_load_factor;
+
+    // While an incremental resizing is in progress, old_hash_set is the
+    // array being resized (otherwise, it's nullptr), and the lists at
+    // indexes below migrated_index have already been moved.
+    ResizeMode resize_mode;
+    Node** old_hash_set;
+    int old_max_capacity;
+    int migrated_index;
+
+    unsigned int hashOf(const ElementType& element) const;
+    void copyHashSet(Node** const &source, Node** target, const unsigned int max_size);
+    static Node** allocateHashSet(const unsigned int max_size);
+    static void freeHashSet(Node** hs) noexcept;
+    template <typename KeyType>
+    bool containsInList(unsigned int hash, const KeyType& element) const;
+    Node* oldListFor(unsigned int hash) const;
+    int capacityFor(long long element_count) const;
+    void rehash(int new_max_capacity);
+    void startMigration(int new_max_capacity);
+    void migrate(int list_count);
+    void finishMigration();
+    void destroyLists(Node** hs, const unsigned int max_size);
 
 };
 
@@ -127,161 +325,331 @@ namespace impl_
     {
         return 0;
     }
+
+
+    template <typename HashPolicy, typename = void>
+    struct HashSet__isRollingHash : std::false_type
+    {
+    };
+
+
+    template <typename HashPolicy>
+    struct HashSet__isRollingHash<HashPolicy, std::void_t<decltype(HashPolicy::ROLLING_HASH_BASE)>>
+        : std::true_type
+    {
+    };
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}, hash_set{new Node*[DEFAULT_CAPACITY]}, max_capacity{DEFAULT_CAPACITY}, current_size{0}
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::HashSet(double maxLoadFactor)
+    : policy{}, nodes{}, hash_set{allocateHashSet(DEFAULT_CAPACITY)}, max_capacity{DEFAULT_CAPACITY}, current_size{0},
+      max_load_factor{maxLoadFactor}, resize_mode{ResizeMode::AllAtOnce}, old_hash_set{nullptr},
+      old_max_capacity{0}, migrated_index{0}
 {
-    initializeHashSet(hash_set, max_capacity);
+    static_assert(!usesHashFunctions, "A HashSet with a FunctionHashPolicy needs a hash function");
+
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::HashSet(HashFunction hashFunction, double maxLoadFactor)
+    : HashSet{hashFunction, LookupHashFunction{}, maxLoadFactor}
 {
-    for (int i = 0; i < max_capacity; ++i)
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::HashSet(
+    HashFunction hashFunction, LookupHashFunction lookupHashFunction, double maxLoadFactor)
+    : policy{}, nodes{}, hash_set{allocateHashSet(DEFAULT_CAPACITY)}, max_capacity{DEFAULT_CAPACITY}, current_size{0},
+      max_load_factor{maxLoadFactor}, resize_mode{ResizeMode::AllAtOnce}, old_hash_set{nullptr},
+      old_max_capacity{0}, migrated_index{0}
+{
+    static_assert(usesHashFunctions, "Only a HashSet with a FunctionHashPolicy takes hash functions");
+
+    if constexpr (usesHashFunctions)
     {
-        Node* node = hash_set[i];
-        while(node != nullptr)
-        {
-            Node* temp = node;
-            node = node->next;
-            delete temp;
-        }
+        policy.hashFunction = hashFunction;
+        policy.lookupHashFunction = lookupHashFunction;
     }
-    delete[] hash_set;
+
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{s.hashFunction}, hash_set{new Node*[DEFAULT_CAPACITY]}, max_capacity{s.max_capacity}, current_size{s.current_size}
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::~HashSet() noexcept
+{
+    destroyLists(hash_set, max_capacity);
+
+    if (old_hash_set != nullptr)
+    {
+        destroyLists(old_hash_set, old_max_capacity);
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::HashSet(const HashSet& s)
+    : policy{s.policy}, nodes{}, hash_set{allocateHashSet(s.max_capacity)}, max_capacity{s.max_capacity}, current_size{s.current_size},
+      max_load_factor{s.max_load_factor}, resize_mode{s.resize_mode}, old_hash_set{nullptr},
+      old_max_capacity{0}, migrated_index{0}
 {
-    initializeHashSet(hash_set, max_capacity);
     copyHashSet(s.hash_set, hash_set, s.max_capacity);
+
+    // The copy's resizing is finished, so any nodes that haven't been
+    // moved out of the old array are copied straight into the new one.
+    if (s.old_hash_set != nullptr)
+    {
+        for (int i = s.migrated_index; i < s.old_max_capacity; ++i)
+        {
+            for (Node* node = s.old_hash_set[i]; node != nullptr; node = node->next)
+            {
+                unsigned int h_index = node->hash % max_capacity;
+                hash_set[h_index] = nodes.create(node->value, node->hash, hash_set[h_index]);
+            }
+        }
+    }
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>::HashSet(HashSet&& s) noexcept
 {
 
-    max_capacity = s.max_capacity;
-    hash_set = new Node*[DEFAULT_CAPACITY];
-    hashFunction = impl_::HashSet__undefinedHashFunction<ElementType>;
+    max_capacity = DEFAULT_CAPACITY;
+    hash_set = allocateHashSet(DEFAULT_CAPACITY);
     current_size = 0;
+    max_load_factor = DEFAULT_MAX_LOAD_FACTOR;
+    resize_mode = ResizeMode::AllAtOnce;
+    old_hash_set = nullptr;
+    old_max_capacity = 0;
+    migrated_index = 0;
+
+    if constexpr (usesHashFunctions)
+    {
+        policy.hashFunction = impl_::HashSet__undefinedHashFunction<ElementType>;
+    }
 
-    initializeHashSet(hash_set, max_capacity);
     std::swap(max_capacity, s.max_capacity);
     std::swap(hash_set, s.hash_set);
-    std::swap(hashFunction, s.hashFunction);
+    std::swap(policy, s.policy);
+    std::swap(nodes, s.nodes);
     std::swap(current_size, s.current_size);
+    std::swap(max_load_factor, s.max_load_factor);
+    std::swap(resize_mode, s.resize_mode);
+    std::swap(old_hash_set, s.old_hash_set);
+    std::swap(old_max_capacity, s.old_max_capacity);
+    std::swap(migrated_index, s.migrated_index);
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>& HashSet<ElementType, HashPolicy, NodeAllocator>::operator=(const HashSet& s)
 {
     if (this != &s)
     {
-        hashFunction = s.hashFunction;
-        max_capacity = s.max_capacity;
-        current_size = s.current_size;
-        this->~HashSet();
-
-        hash_set = new Node*[max_capacity];
-        initializeHashSet(hash_set, max_capacity);
-        copyHashSet(s.hash_set, hash_set, max_capacity);
+        HashSet copy{s};
+        *this = std::move(copy);
     }
     return *this;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+HashSet<ElementType, HashPolicy, NodeAllocator>& HashSet<ElementType, HashPolicy, NodeAllocator>::operator=(HashSet&& s) noexcept
 {
     if (this != &s)
     {
-        std::swap(hashFunction, s.hashFunction);
+        std::swap(policy, s.policy);
+        std::swap(nodes, s.nodes);
         std::swap(max_capacity, s.max_capacity);
         std::swap(current_size, s.current_size);
-        std::swap(hash_set, s.hash_set);  
+        std::swap(max_load_factor, s.max_load_factor);
+        std::swap(hash_set, s.hash_set);
+        std::swap(resize_mode, s.resize_mode);
+        std::swap(old_hash_set, s.old_hash_set);
+        std::swap(old_max_capacity, s.old_max_capacity);
+        std::swap(migrated_index, s.migrated_index);
     }
     return *this;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::isImplemented() const noexcept
 {
     return true;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::add(const ElementType& element)
 {
-    if (!contains(element))
+    if (old_hash_set != nullptr)
+    {
+        migrate(MIGRATION_STEP);
+    }
+
+    unsigned int hash = hashOf(element);
+
+    if (!containsInList(hash, element))
     {
-        if ((double)(current_size + 1) > max_capacity)
+        if ((double)(current_size + 1) > max_load_factor * max_capacity)
         {
-            int new_max_capacity = max_capacity * 2;
-            Node** new_hash_set = new Node*[new_max_capacity];
-            initializeHashSet(new_hash_set, new_max_capacity);
+            int new_max_capacity = std::max(max_capacity * 2, capacityFor(current_size + 1));
 
-            for (int i = 0; i < max_capacity; ++i)
+            if (resize_mode == ResizeMode::Incremental)
             {
-                Node* node = hash_set[i];
-
-                while (node != nullptr)
-                {
-                    Node* temp = node;
-                    unsigned int hash_index = hashFunction(node->value) % new_max_capacity;
-                    node = node->next;
-                    addToHashSet(new_hash_set[hash_index], temp);
-                }
+                startMigration(new_max_capacity);
+            }
+            else
+            {
+                rehash(new_max_capacity);
             }
-            delete[] hash_set;
-            max_capacity = new_max_capacity;
-            hash_set = new_hash_set;
         }
 
-        unsigned int h_index = hashFunction(element) % max_capacity;
-        Node* new_node = new Node{element, hash_set[h_index]};
+        unsigned int h_index = hash % max_capacity;
+        Node* new_node = nodes.create(element, hash, hash_set[h_index]);
         hash_set[h_index] = new_node;
         current_size++;
     }
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::bulkLoad(const ElementType* first, const ElementType* last)
 {
-    unsigned int hash_index = hashFunction(element) % max_capacity;
-    Node* node = hash_set[hash_index];
+    reserve(static_cast<unsigned int>(current_size + (last - first)));
 
-    while(node != nullptr)
+    for (; first != last; ++first)
     {
-        if (node->value == element)
+        add(*first);
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::reserve(unsigned int elementCount)
+{
+    int new_max_capacity = capacityFor(elementCount);
+
+    finishMigration();
+
+    if (new_max_capacity > max_capacity)
+    {
+        rehash(new_max_capacity);
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::contains(const ElementType& element) const
+{
+    return containsInList(hashOf(element), element);
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string> && usesHashFunctions)
+    {
+        if (!policy.lookupHashFunction)
         {
-            return true;
+            return contains(ElementType{element});
         }
-        node = node->next;
+
+        return containsInList(policy.lookupHashFunction(element), element);
+    }
+    else if constexpr (std::is_same_v<ElementType, std::string>
+        && std::is_invocable_r_v<unsigned int, const HashPolicy&, std::string_view>)
+    {
+        return containsInList(policy(element), element);
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
     }
-    return false;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::rollingHashBase() const noexcept
+{
+    if constexpr (impl_::HashSet__isRollingHash<HashPolicy>::value)
+    {
+        return HashPolicy::ROLLING_HASH_BASE;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::containsHashed(unsigned int hash, std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string> && impl_::HashSet__isRollingHash<HashPolicy>::value)
+    {
+        return containsInList(hash, element);
+    }
+    else
+    {
+        return contains(element);
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::size() const noexcept
 {
     return current_size;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::capacity() const noexcept
+{
+    return max_capacity;
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+double HashSet<ElementType, HashPolicy, NodeAllocator>::maxLoadFactor() const noexcept
+{
+    return max_load_factor;
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::setResizeMode(ResizeMode mode)
+{
+    resize_mode = mode;
+
+    if (resize_mode == ResizeMode::AllAtOnce)
+    {
+        finishMigration();
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+typename HashSet<ElementType, HashPolicy, NodeAllocator>::ResizeMode HashSet<ElementType, HashPolicy, NodeAllocator>::resizeMode() const noexcept
+{
+    return resize_mode;
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::isResizing() const noexcept
+{
+    return old_hash_set != nullptr;
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::elementsAtIndex(unsigned int index) const
 {
     unsigned int count = 0;
 
@@ -296,12 +664,26 @@ unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
         count++;
         node = node->next;
     }
+
+    if (old_hash_set != nullptr)
+    {
+        for (int i = migrated_index; i < old_max_capacity; ++i)
+        {
+            for (node = old_hash_set[i]; node != nullptr; node = node->next)
+            {
+                if (node->hash % max_capacity == index)
+                {
+                    count++;
+                }
+            }
+        }
+    }
     return count;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
     if (index >= max_capacity)
     {
@@ -317,46 +699,306 @@ bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned
         }
         node = node->next;
     }
+
+    if (old_hash_set != nullptr)
+    {
+        for (int i = migrated_index; i < old_max_capacity; ++i)
+        {
+            for (node = old_hash_set[i]; node != nullptr; node = node->next)
+            {
+                if (node->hash % max_capacity == index && node->value == element)
+                {
+                    return true;
+                }
+            }
+        }
+    }
     return false;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::initializeHashSet(Node** hs, const unsigned int max_size) const
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::nodesSearched(const ElementType& element) const
 {
-    for (int i = 0; i < max_size; ++i)
+    unsigned int hash = hashOf(element);
+    unsigned int count = 0;
+
+    for (Node* list : {hash_set[hash % max_capacity], oldListFor(hash)})
     {
-        hs[i] = nullptr;
+        for (Node* node = list; node != nullptr; node = node->next)
+        {
+            count++;
+
+            if (node->hash == hash && node->value == element)
+            {
+                return count;
+            }
+        }
     }
+    return count;
 }
 
 
-template <typename ElementType>
-void HashSet<ElementType>::copyHashSet(Node** const &source, Node** target, const unsigned int max_size) const
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::elementComparisons(const ElementType& element) const
+{
+    unsigned int hash = hashOf(element);
+    unsigned int count = 0;
+
+    for (Node* list : {hash_set[hash % max_capacity], oldListFor(hash)})
+    {
+        for (Node* node = list; node != nullptr; node = node->next)
+        {
+            if (node->hash == hash)
+            {
+                count++;
+
+                if (node->value == element)
+                {
+                    return count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+unsigned int HashSet<ElementType, HashPolicy, NodeAllocator>::hashOf(const ElementType& element) const
+{
+    if constexpr (usesHashFunctions)
+    {
+        return policy.hashFunction(element);
+    }
+    else
+    {
+        return policy(element);
+    }
+}
+
+
+// containsInList() searches the list at the index for the given hash,
+// only comparing the element with the nodes whose hashes match.  While an
+// incremental resizing is in progress, the element may instead be in the
+// old array's list, which is searched next.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+template <typename KeyType>
+bool HashSet<ElementType, HashPolicy, NodeAllocator>::containsInList(unsigned int hash, const KeyType& element) const
+{
+    Node* node = hash_set[hash % max_capacity];
+
+    while (node != nullptr)
+    {
+        if (node->hash == hash && node->value == element)
+        {
+            return true;
+        }
+        node = node->next;
+    }
+
+    for (node = oldListFor(hash); node != nullptr; node = node->next)
+    {
+        if (node->hash == hash && node->value == element)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// oldListFor() returns the list in the old array at the index for the
+// given hash, which is empty if it's already been moved, or nullptr if no
+// incremental resizing is in progress.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+typename HashSet<ElementType, HashPolicy, NodeAllocator>::Node* HashSet<ElementType, HashPolicy, NodeAllocator>::oldListFor(unsigned int hash) const
+{
+    if (old_hash_set == nullptr)
+    {
+        return nullptr;
+    }
+
+    return old_hash_set[hash % old_max_capacity];
+}
+
+
+// allocateHashSet() allocates an array of empty lists with std::calloc()
+// rather than new[], because a large enough block from std::calloc() is
+// made of pages that the operating system has already zeroed; they don't
+// have to be touched (and, so, brought into memory) until they're first
+// used.  That keeps the beginning of an incremental resizing from taking
+// time proportional to the new capacity.  Arrays allocated this way must
+// be freed by freeHashSet().
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+typename HashSet<ElementType, HashPolicy, NodeAllocator>::Node** HashSet<ElementType, HashPolicy, NodeAllocator>::allocateHashSet(const unsigned int max_size)
+{
+    void* hs = std::calloc(max_size, sizeof(Node*));
+
+    if (hs == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return static_cast<Node**>(hs);
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::freeHashSet(Node** hs) noexcept
+{
+    std::free(hs);
+}
+
+
+// copyHashSet() copies each of the lists in the source array into the
+// corresponding cell of the target array, keeping the nodes in the same
+// order.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::copyHashSet(Node** const &source, Node** target, const unsigned int max_size)
 {
     for (int i = 0; i < max_size; ++i)
     {
-        Node* copied_pointer = source[i];
-        Node* target_pointer = target[i];
-        if (copied_pointer == nullptr)
+        Node** target_pointer = &target[i];
+
+        for (Node* copied_pointer = source[i]; copied_pointer != nullptr; copied_pointer = copied_pointer->next)
         {
-            target_pointer = nullptr;
+            *target_pointer = nodes.create(copied_pointer->value, copied_pointer->hash, nullptr);
+            target_pointer = &(*target_pointer)->next;
         }
-        while (copied_pointer != nullptr)
+    }
+}
+
+
+// capacityFor() returns the smallest capacity that can hold the given
+// number of elements without exceeding the maximum load factor.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+int HashSet<ElementType, HashPolicy, NodeAllocator>::capacityFor(long long element_count) const
+{
+    return std::max(1, static_cast<int>(std::ceil(element_count / max_load_factor)));
+}
+
+
+// rehash() moves every node into a new array with the given capacity,
+// relinking the nodes rather than allocating new ones, and using their
+// cached hashes rather than hashing their elements again.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::rehash(int new_max_capacity)
+{
+    finishMigration();
+
+    Node** new_hash_set = allocateHashSet(new_max_capacity);
+
+    for (int i = 0; i < max_capacity; ++i)
+    {
+        Node* node = hash_set[i];
+
+        while (node != nullptr)
         {
-            target_pointer->value = copied_pointer->value;
-            target_pointer->next = copied_pointer->next;
-            copied_pointer = copied_pointer->next;
-            target_pointer = target_pointer->next;
+            Node* next = node->next;
+            unsigned int hash_index = node->hash % new_max_capacity;
+            node->next = new_hash_set[hash_index];
+            new_hash_set[hash_index] = node;
+            node = next;
         }
     }
+    freeHashSet(hash_set);
+    max_capacity = new_max_capacity;
+    hash_set = new_hash_set;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::addToHashSet(Node* &first_pointer, Node* &old_node) const
+
+// startMigration() begins an incremental resizing: the current array
+// becomes the old one, and an empty array with the given capacity takes
+// its place.  If a resizing is already in progress (which can only happen
+// when the set grows faster than MIGRATION_STEP lists per add() can keep
+// up with), it's finished first, so there's never more than one old array.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::startMigration(int new_max_capacity)
+{
+    finishMigration();
+
+    Node** new_hash_set = allocateHashSet(new_max_capacity);
+
+    old_hash_set = hash_set;
+    old_max_capacity = max_capacity;
+    migrated_index = 0;
+
+    hash_set = new_hash_set;
+    max_capacity = new_max_capacity;
+}
+
+
+// migrate() moves the nodes in the next list_count lists of the old array
+// into the new one, deleting the old array once every list has been moved.
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::migrate(int list_count)
 {
-    Node* new_node = new Node{old_node->value, first_pointer};
-    first_pointer = new_node;
-    delete old_node;
+    int last_index = std::min(old_max_capacity, migrated_index + list_count);
+
+    for (; migrated_index < last_index; ++migrated_index)
+    {
+        Node* node = old_hash_set[migrated_index];
+        old_hash_set[migrated_index] = nullptr;
+
+        while (node != nullptr)
+        {
+            Node* next = node->next;
+            unsigned int hash_index = node->hash % max_capacity;
+            node->next = hash_set[hash_index];
+            hash_set[hash_index] = node;
+            node = next;
+        }
+    }
+
+    if (migrated_index == old_max_capacity)
+    {
+        freeHashSet(old_hash_set);
+        old_hash_set = nullptr;
+        old_max_capacity = 0;
+        migrated_index = 0;
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::finishMigration()
+{
+    if (old_hash_set != nullptr)
+    {
+        migrate(old_max_capacity);
+    }
+}
+
+
+template <typename ElementType, typename HashPolicy, template <typename> class NodeAllocator>
+void HashSet<ElementType, HashPolicy, NodeAllocator>::destroyLists(Node** hs, const unsigned int max_size)
+{
+    if constexpr (NodeAllocator<Node>::DESTROYS_ALL_AT_ONCE)
+    {
+        nodes.destroyAll();
+    }
+    else
+    {
+        for (unsigned int i = 0; i < max_size; ++i)
+        {
+            Node* node = hs[i];
+            while(node != nullptr)
+            {
+                Node* temp = node;
+                node = node->next;
+                nodes.destroy(temp);
+            }
+        }
+    }
+    freeHashSet(hs);
 }
 
 
@@ -0,0 +1,178 @@
+// LevenshteinAutomaton.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <algorithm>
+#include "LevenshteinAutomaton.hpp"
+
+
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view word, unsigned int maxDistance)
+    : word{word}, limit{std::min(maxDistance, MAX_DISTANCE)}
+{
+    std::size_t width = bandWidth();
+    unsigned char cap = static_cast<unsigned char>(limit + 1);
+
+    // A walk never pushes more than one character past the point where
+    // canMatch() becomes false, which is at most word.size() + limit + 1
+    // characters in.
+    rows.resize(rowSize() * (word.size() + limit + 2));
+    pushed.reserve(word.size() + limit + 1);
+
+    // Entry b of the initial row is the distance between the first
+    // b - limit characters of the word and the empty string.
+    for (std::size_t b = 0; b < width; ++b)
+    {
+        rows[b] = b < limit || b - limit > word.size() ? cap : static_cast<unsigned char>(b - limit);
+    }
+
+    rows[width] = 0;
+}
+
+
+// Entry j of row i of the usual table is the distance between the first j
+// characters of the word and the first i characters pushed.  It's at least
+// |i - j|, so only the entries within limit of the diagonal can be within
+// limit; the rest are all capped.  Each row stores just that band: entry b
+// of row i holds column j = i + b - limit, and any column outside the word
+// reads as capped.  Moving up a row shifts the band one column left, so the
+// entries above, diagonally above, and two diagonally above column j are
+// at b + 1, b, and b of their rows, and the one to the left is at b - 1.
+
+void LevenshteinAutomaton::push(char c)
+{
+    std::size_t width = bandWidth();
+    std::size_t depth = pushed.size();
+    std::size_t i = depth + 1;
+    unsigned char cap = static_cast<unsigned char>(limit + 1);
+
+    if (rows.size() < (i + 1) * rowSize())
+    {
+        rows.resize((i + 1) * rowSize());
+    }
+
+    const unsigned char* above = row(depth);
+    const unsigned char* twoAbove = depth > 0 ? row(depth - 1) : nullptr;
+    unsigned char* next = rows.data() + i * rowSize();
+
+    // Only the entries from first through last are columns of the word;
+    // the band hangs off its left end near the top of the table, and off
+    // its right end once more characters than it has have been pushed.
+    std::size_t first = i < limit ? limit - i : 0;
+    std::size_t last = i > word.size() + limit ? 0 : std::min(width, word.size() + limit + 1 - i);
+
+    unsigned char minimum = cap;
+    unsigned int left = cap;
+    char previous = depth > 0 ? pushed[depth - 1] : '\0';
+
+    for (std::size_t b = 0; b < first; ++b)
+    {
+        next[b] = cap;
+    }
+
+    for (std::size_t b = first; b < last; ++b)
+    {
+        std::size_t j = i + b - limit;
+        unsigned int best;
+
+        if (j == 0)
+        {
+            best = static_cast<unsigned int>(std::min<std::size_t>(i, cap));
+        }
+        else
+        {
+            best = std::min<unsigned int>(above[b] + (word[j - 1] == c ? 0 : 1), left + 1);
+
+            if (b + 1 < width)
+            {
+                best = std::min<unsigned int>(best, above[b + 1] + 1);
+            }
+
+            if (twoAbove != nullptr && j >= 2 && word[j - 2] == c && word[j - 1] == previous)
+            {
+                best = std::min<unsigned int>(best, twoAbove[b] + 1);
+            }
+
+            best = std::min<unsigned int>(best, cap);
+        }
+
+        next[b] = static_cast<unsigned char>(best);
+        left = best;
+        minimum = std::min(minimum, next[b]);
+    }
+
+    for (std::size_t b = std::max(first, last); b < width; ++b)
+    {
+        next[b] = cap;
+    }
+
+    next[width] = minimum;
+    pushed.push_back(c);
+}
+
+
+void LevenshteinAutomaton::pop()
+{
+    if (!pushed.empty())
+    {
+        pushed.pop_back();
+    }
+}
+
+
+bool LevenshteinAutomaton::canMatch() const noexcept
+{
+    return row(pushed.size())[bandWidth()] <= limit;
+}
+
+
+bool LevenshteinAutomaton::isMatch() const noexcept
+{
+    return distance() <= limit;
+}
+
+
+unsigned int LevenshteinAutomaton::distance() const noexcept
+{
+    // The word's last column is at entry word.size() - depth + limit of the
+    // current row, if that's within the band at all.
+    std::size_t depth = pushed.size();
+
+    if (word.size() + limit < depth || word.size() + limit - depth >= bandWidth())
+    {
+        return limit + 1;
+    }
+
+    return row(depth)[word.size() + limit - depth];
+}
+
+
+unsigned int LevenshteinAutomaton::maxDistance() const noexcept
+{
+    return limit;
+}
+
+
+std::string_view LevenshteinAutomaton::current() const noexcept
+{
+    return pushed;
+}
+
+
+const unsigned char* LevenshteinAutomaton::row(std::size_t depth) const noexcept
+{
+    return rows.data() + depth * rowSize();
+}
+
+
+std::size_t LevenshteinAutomaton::bandWidth() const noexcept
+{
+    return 2 * limit + 1;
+}
+
+
+std::size_t LevenshteinAutomaton::rowSize() const noexcept
+{
+    return bandWidth() + 1;
+}
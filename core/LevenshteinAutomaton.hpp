@@ -0,0 +1,93 @@
+// LevenshteinAutomaton.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A LevenshteinAutomaton recognizes the strings that are within some small
+// edit distance k of a given word, where an edit is an insertion, deletion,
+// or replacement of one character, or a swap of two adjacent characters
+// (i.e., the "optimal string alignment" distance, which matches the edits
+// that WordChecker suggests).
+//
+// Rather than being handed whole strings, the automaton is fed a string one
+// character at a time with push(), and can be backed up with pop().  After
+// each push(), canMatch() says whether any string beginning with what has
+// been pushed so far could still be within k edits.  That makes it a good
+// fit for walking a trie (or any other structure that shares prefixes):
+// push a character on the way down, stop descending as soon as canMatch()
+// is false, and pop() on the way back up.  isMatch() says whether the
+// string pushed so far is itself within k edits.
+//
+// Internally, the automaton is simulated rather than built: its state is
+// one row of the usual dynamic programming table for edit distance, with
+// entries capped at k + 1 (since all larger distances are equivalent).
+// Only the 2k + 1 entries nearest the diagonal can be k or less, so only
+// they're kept, and each push() costs O(k) time however long the word is.
+// One row is kept for each character pushed.
+
+#ifndef LEVENSHTEINAUTOMATON_HPP
+#define LEVENSHTEINAUTOMATON_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+class LevenshteinAutomaton
+{
+public:
+    // The largest edit distance an automaton can be built for.
+    static constexpr unsigned int MAX_DISTANCE = 3;
+
+public:
+    // Initializes an automaton recognizing strings within maxDistance edits
+    // of the given word.  A maxDistance larger than MAX_DISTANCE is treated
+    // as MAX_DISTANCE.  The word is copied.
+    LevenshteinAutomaton(std::string_view word, unsigned int maxDistance);
+
+    // push() feeds the next character of the string to the automaton.
+    void push(char c);
+
+    // pop() backs up over the most recently pushed character.
+    void pop();
+
+    // canMatch() returns true if some string beginning with the characters
+    // pushed so far is within the maximum distance of the word.
+    bool canMatch() const noexcept;
+
+    // isMatch() returns true if the characters pushed so far form a string
+    // within the maximum distance of the word.
+    bool isMatch() const noexcept;
+
+    // distance() returns the edit distance between the word and the string
+    // pushed so far, or maxDistance() + 1 if it's larger than maxDistance().
+    unsigned int distance() const noexcept;
+
+    // maxDistance() returns the maximum distance the automaton recognizes.
+    unsigned int maxDistance() const noexcept;
+
+    // current() returns the characters pushed so far.
+    std::string_view current() const noexcept;
+
+
+private:
+    std::string word;
+    unsigned int limit;
+
+    // rows holds the band of one row (bandWidth() entries, followed by the
+    // smallest of them) for each character pushed, plus the initial row.
+    // It only ever grows, so that pop() and the push() after it don't
+    // need to allocate or free anything.
+    std::vector<unsigned char> rows;
+    std::string pushed;
+
+    const unsigned char* row(std::size_t depth) const noexcept;
+    std::size_t bandWidth() const noexcept;
+    std::size_t rowSize() const noexcept;
+};
+
+
+
+#endif // LEVENSHTEINAUTOMATON_HPP
@@ -0,0 +1,156 @@
+// MappedFile.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <fstream>
+#include <utility>
+#include "MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPEDFILE_USE_MMAP 1
+#endif
+
+
+
+MappedFile::MappedFile() noexcept
+    : mapping{nullptr}, buffer{nullptr}, size_{0}, open{false}
+{
+}
+
+
+MappedFile::MappedFile(const std::string& path)
+    : MappedFile{}
+{
+#ifdef MAPPEDFILE_USE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd >= 0)
+    {
+        struct stat info;
+
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            std::size_t length = static_cast<std::size_t>(info.st_size);
+            void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (mapped != MAP_FAILED)
+            {
+                mapping = mapped;
+                size_ = length;
+                open = true;
+            }
+        }
+
+        ::close(fd);
+
+        if (open)
+        {
+            return;
+        }
+    }
+#endif
+
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    std::streamoff length = file.tellg();
+    file.seekg(0);
+
+    if (length > 0)
+    {
+        buffer = new char[static_cast<std::size_t>(length)];
+
+        if (!file.read(buffer, length))
+        {
+            release();
+            return;
+        }
+
+        size_ = static_cast<std::size_t>(length);
+    }
+
+    open = true;
+}
+
+
+MappedFile::~MappedFile() noexcept
+{
+    release();
+}
+
+
+MappedFile::MappedFile(MappedFile&& f) noexcept
+    : MappedFile{}
+{
+    std::swap(mapping, f.mapping);
+    std::swap(buffer, f.buffer);
+    std::swap(size_, f.size_);
+    std::swap(open, f.open);
+}
+
+
+MappedFile& MappedFile::operator=(MappedFile&& f) noexcept
+{
+    std::swap(mapping, f.mapping);
+    std::swap(buffer, f.buffer);
+    std::swap(size_, f.size_);
+    std::swap(open, f.open);
+    return *this;
+}
+
+
+bool MappedFile::isOpen() const noexcept
+{
+    return open;
+}
+
+
+bool MappedFile::isMapped() const noexcept
+{
+    return mapping != nullptr;
+}
+
+
+const char* MappedFile::data() const noexcept
+{
+    return mapping != nullptr ? static_cast<const char*>(mapping) : buffer;
+}
+
+
+std::size_t MappedFile::size() const noexcept
+{
+    return size_;
+}
+
+
+std::string_view MappedFile::contents() const noexcept
+{
+    return std::string_view{data(), size_};
+}
+
+
+void MappedFile::release() noexcept
+{
+#ifdef MAPPEDFILE_USE_MMAP
+    if (mapping != nullptr)
+    {
+        ::munmap(mapping, size_);
+    }
+#endif
+
+    delete[] buffer;
+
+    mapping = nullptr;
+    buffer = nullptr;
+    size_ = 0;
+    open = false;
+}
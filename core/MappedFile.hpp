@@ -0,0 +1,62 @@
+// MappedFile.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A MappedFile makes the whole contents of a file available in memory,
+// read-only, for as long as it exists.  Where possible, the file is mapped
+// with mmap(), so that nothing is copied and pages are only read when
+// they're touched; otherwise (e.g., the file is empty, or the platform has
+// no mmap()), the file is read into a buffer instead.  Either way, the
+// contents begin at an address suitably aligned for any integer type.
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+
+class MappedFile
+{
+public:
+    // Initializes a MappedFile with no file.
+    MappedFile() noexcept;
+
+    // Initializes a MappedFile with the contents of the given file.  If the
+    // file can't be opened, isOpen() returns false.
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile() noexcept;
+
+    MappedFile(MappedFile&& f) noexcept;
+    MappedFile& operator=(MappedFile&& f) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    // isOpen() returns true if the file was opened, and isMapped() returns
+    // true if it was mapped (rather than read into a buffer).
+    bool isOpen() const noexcept;
+    bool isMapped() const noexcept;
+
+    const char* data() const noexcept;
+    std::size_t size() const noexcept;
+    std::string_view contents() const noexcept;
+
+
+private:
+    void* mapping;
+    char* buffer;
+    std::size_t size_;
+    bool open;
+
+    void release() noexcept;
+};
+
+
+
+#endif // MAPPEDFILE_HPP
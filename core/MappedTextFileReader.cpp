@@ -0,0 +1,99 @@
+// MappedTextFileReader.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <cctype>
+#include <cstring>
+#include "MappedTextFileReader.hpp"
+#include "TextFileReader.hpp"
+
+
+
+MappedTextFileReader::MappedTextFileReader(const std::string& textFilePath)
+    : file{textFilePath}, text{file.contents()}, nextLineStart{0}, lineIndex{0}, eof{false}
+{
+    if (advanceToNextLine())
+    {
+        advanceToNextWord();
+    }
+}
+
+
+bool MappedTextFileReader::noMoreWords() const
+{
+    return eof;
+}
+
+
+void MappedTextFileReader::advanceToNextWord()
+{
+    std::size_t start;
+    std::size_t length;
+
+    while (!TextFileReader::nextWordSpanInLine(line, lineIndex, start, length))
+    {
+        if (!advanceToNextLine())
+        {
+            word = std::string_view{};
+            return;
+        }
+    }
+
+    word = line.substr(start, length);
+
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        if (std::islower(static_cast<unsigned char>(word[i])))
+        {
+            folded.assign(word);
+
+            for (std::size_t j = i; j < folded.size(); ++j)
+            {
+                folded[j] = std::toupper(static_cast<unsigned char>(folded[j]));
+            }
+
+            word = folded;
+            break;
+        }
+    }
+}
+
+
+std::string_view MappedTextFileReader::currentLine() const
+{
+    return line;
+}
+
+
+std::string_view MappedTextFileReader::currentWord() const
+{
+    return word;
+}
+
+
+// Lines are split the same way std::getline() splits them: at each newline,
+// with no empty line after a newline that ends the file.
+
+bool MappedTextFileReader::advanceToNextLine()
+{
+    if (nextLineStart >= text.size())
+    {
+        eof = true;
+        line = std::string_view{};
+        return false;
+    }
+
+    const char* start = text.data() + nextLineStart;
+    std::size_t remaining = text.size() - nextLineStart;
+    const void* newline = std::memchr(start, '\n', remaining);
+
+    std::size_t length = newline != nullptr
+        ? static_cast<std::size_t>(static_cast<const char*>(newline) - start)
+        : remaining;
+
+    line = std::string_view{start, length};
+    nextLineStart += length + 1;
+    lineIndex = 0;
+    return true;
+}
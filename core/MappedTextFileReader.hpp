@@ -0,0 +1,64 @@
+// MappedTextFileReader.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A MappedTextFileReader consumes a text file word by word, using exactly
+// the same rules as a TextFileReader, but without copying the file into
+// std::strings as it goes.  The whole file is mapped into memory, and the
+// current line and word are std::string_views into that mapping.  The only
+// exception is a word containing lowercase letters, which is converted to
+// uppercase in a buffer that's reused from one word to the next.
+//
+// The views returned by currentLine() and currentWord() are only valid
+// until the next call to advanceToNextWord() (or until the reader is
+// destroyed), so callers that need to keep them must copy them.
+//
+// If the file can't be mapped, it's read into memory instead (see
+// MappedFile); if it can't be opened at all, the reader simply has no
+// words, like a TextFileReader.
+
+#ifndef MAPPEDTEXTFILEREADER_HPP
+#define MAPPEDTEXTFILEREADER_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "MappedFile.hpp"
+
+
+
+class MappedTextFileReader
+{
+public:
+    MappedTextFileReader(const std::string& textFilePath);
+
+    MappedTextFileReader(const MappedTextFileReader&) = delete;
+    MappedTextFileReader& operator=(const MappedTextFileReader&) = delete;
+
+    bool noMoreWords() const;
+    void advanceToNextWord();
+
+    std::string_view currentLine() const;
+    std::string_view currentWord() const;
+
+
+private:
+    MappedFile file;
+    std::string_view text;
+
+    // nextLineStart is where the line after the current one begins, and
+    // lineIndex is how far into the current line the words have been read.
+    std::size_t nextLineStart;
+    std::size_t lineIndex;
+    std::string_view line;
+    std::string_view word;
+    std::string folded;
+    bool eof;
+
+    bool advanceToNextLine();
+};
+
+
+
+#endif // MAPPEDTEXTFILEREADER_HPP
@@ -0,0 +1,275 @@
+// NodeAllocator.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The node-based sets (HashSet and AVLSet) take a NodeAllocator as a
+// template parameter, which decides where their nodes live.  A
+// NodeAllocator is a class template whose parameter is the node type, with
+// these members:
+//
+//   * create(args...) constructs a node from the given arguments, in the
+//     same way that new Node{args...} would, and returns a pointer to it.
+//   * destroy(node) is called once for each node that the set no longer
+//     needs.
+//   * If DESTROYS_ALL_AT_ONCE is true, destroyAll() destroys every node
+//     that create() has returned, so a set tearing itself down calls it
+//     instead of visiting each of its nodes to destroy() them one by one.
+//
+// HeapNodeAllocator, which the sets use unless they're given another one,
+// allocates each node separately with new and deletes it in destroy().
+//
+// ArenaNodeAllocator instead places nodes one after another, in the order
+// they're created, in large blocks of memory.  Nodes created together
+// (e.g., by bulkLoad()) then share cache lines and pages, rather than
+// being scattered across the heap.  Its destroy() does nothing; instead,
+// destroyAll() (which its destructor also calls) runs the destructors of
+// all of the nodes by walking through the blocks in order, rather than by
+// following the set's pointers, then frees the blocks, so tearing down a
+// set takes one deallocation per block rather than one per node.  (When
+// the node type is trivially destructible, the destructors aren't run at
+// all, so the whole teardown takes time proportional to the number of
+// blocks.)  The blocks start small, so small sets don't waste memory, and
+// double in size up to MAX_BLOCK_BYTES.
+//
+// The sets never remove individual elements, which is what makes it
+// reasonable to hold on to every node until the whole set is destroyed.
+
+#ifndef NODEALLOCATOR_HPP
+#define NODEALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+template <typename NodeType>
+class HeapNodeAllocator
+{
+public:
+    static constexpr bool DESTROYS_ALL_AT_ONCE = false;
+
+    template <typename... Args>
+    NodeType* create(Args&&... args);
+
+    void destroy(NodeType* node) noexcept;
+    void destroyAll() noexcept;
+};
+
+
+
+template <typename NodeType>
+class ArenaNodeAllocator
+{
+public:
+    static constexpr bool DESTROYS_ALL_AT_ONCE = true;
+
+    // The number of nodes in the first block, and the largest size, in
+    // bytes, that the blocks grow to.
+    static constexpr std::size_t FIRST_BLOCK_NODES = 16;
+    static constexpr std::size_t MAX_BLOCK_BYTES = std::size_t{1} << 20;
+
+public:
+    ArenaNodeAllocator() noexcept;
+    ~ArenaNodeAllocator() noexcept;
+
+    // The nodes belong to the arena, so it can't be copied, but moving it
+    // takes its blocks (and the nodes in them) along.
+    ArenaNodeAllocator(const ArenaNodeAllocator& a) = delete;
+    ArenaNodeAllocator(ArenaNodeAllocator&& a) noexcept;
+    ArenaNodeAllocator& operator=(const ArenaNodeAllocator& a) = delete;
+    ArenaNodeAllocator& operator=(ArenaNodeAllocator&& a) noexcept;
+
+    template <typename... Args>
+    NodeType* create(Args&&... args);
+
+    void destroy(NodeType* node) noexcept;
+    void destroyAll() noexcept;
+
+    // blockCount() returns the number of blocks allocated, and nodeCount()
+    // returns the number of nodes created, since the last destroyAll().
+    unsigned int blockCount() const noexcept;
+    std::size_t nodeCount() const noexcept;
+
+
+private:
+    // Each block begins with a Block, followed (after any padding needed
+    // to align them) by room for its capacity's worth of nodes, the first
+    // "used" of which have been created.  The blocks form a linked list
+    // from the newest to the oldest.
+    struct Block
+    {
+        Block* previous;
+        std::size_t capacity;
+        std::size_t used;
+    };
+
+    static_assert(alignof(NodeType) <= alignof(std::max_align_t), "Over-aligned nodes aren't supported");
+
+    static constexpr std::size_t NODES_OFFSET =
+        (sizeof(Block) + alignof(NodeType) - 1) / alignof(NodeType) * alignof(NodeType);
+
+    Block* current;
+    unsigned int block_count;
+    std::size_t node_count;
+
+    static NodeType* nodesIn(Block* block) noexcept;
+    void addBlock();
+};
+
+
+
+template <typename NodeType>
+template <typename... Args>
+NodeType* HeapNodeAllocator<NodeType>::create(Args&&... args)
+{
+    return new NodeType{std::forward<Args>(args)...};
+}
+
+
+template <typename NodeType>
+void HeapNodeAllocator<NodeType>::destroy(NodeType* node) noexcept
+{
+    delete node;
+}
+
+
+template <typename NodeType>
+void HeapNodeAllocator<NodeType>::destroyAll() noexcept
+{
+}
+
+
+
+template <typename NodeType>
+ArenaNodeAllocator<NodeType>::ArenaNodeAllocator() noexcept
+    : current{nullptr}, block_count{0}, node_count{0}
+{
+}
+
+
+template <typename NodeType>
+ArenaNodeAllocator<NodeType>::~ArenaNodeAllocator() noexcept
+{
+    destroyAll();
+}
+
+
+template <typename NodeType>
+ArenaNodeAllocator<NodeType>::ArenaNodeAllocator(ArenaNodeAllocator&& a) noexcept
+    : current{nullptr}, block_count{0}, node_count{0}
+{
+    std::swap(current, a.current);
+    std::swap(block_count, a.block_count);
+    std::swap(node_count, a.node_count);
+}
+
+
+template <typename NodeType>
+ArenaNodeAllocator<NodeType>& ArenaNodeAllocator<NodeType>::operator=(ArenaNodeAllocator&& a) noexcept
+{
+    if (this != &a)
+    {
+        std::swap(current, a.current);
+        std::swap(block_count, a.block_count);
+        std::swap(node_count, a.node_count);
+    }
+    return *this;
+}
+
+
+template <typename NodeType>
+template <typename... Args>
+NodeType* ArenaNodeAllocator<NodeType>::create(Args&&... args)
+{
+    if (current == nullptr || current->used == current->capacity)
+    {
+        addBlock();
+    }
+
+    // The node only counts as used once it's been constructed, so a
+    // constructor that throws leaves nothing for destroyAll() to destroy.
+    NodeType* node = ::new (static_cast<void*>(nodesIn(current) + current->used))
+        NodeType{std::forward<Args>(args)...};
+
+    current->used++;
+    node_count++;
+    return node;
+}
+
+
+template <typename NodeType>
+void ArenaNodeAllocator<NodeType>::destroy(NodeType* /* node */) noexcept
+{
+}
+
+
+template <typename NodeType>
+void ArenaNodeAllocator<NodeType>::destroyAll() noexcept
+{
+    while (current != nullptr)
+    {
+        Block* previous = current->previous;
+
+        if constexpr (!std::is_trivially_destructible_v<NodeType>)
+        {
+            NodeType* nodes = nodesIn(current);
+
+            for (std::size_t i = 0; i < current->used; ++i)
+            {
+                std::launder(nodes + i)->~NodeType();
+            }
+        }
+
+        ::operator delete(current);
+        current = previous;
+    }
+
+    block_count = 0;
+    node_count = 0;
+}
+
+
+template <typename NodeType>
+unsigned int ArenaNodeAllocator<NodeType>::blockCount() const noexcept
+{
+    return block_count;
+}
+
+
+template <typename NodeType>
+std::size_t ArenaNodeAllocator<NodeType>::nodeCount() const noexcept
+{
+    return node_count;
+}
+
+
+template <typename NodeType>
+NodeType* ArenaNodeAllocator<NodeType>::nodesIn(Block* block) noexcept
+{
+    return reinterpret_cast<NodeType*>(reinterpret_cast<char*>(block) + NODES_OFFSET);
+}
+
+
+template <typename NodeType>
+void ArenaNodeAllocator<NodeType>::addBlock()
+{
+    std::size_t max_capacity = std::max(std::size_t{1}, MAX_BLOCK_BYTES / sizeof(NodeType));
+    std::size_t capacity = std::min(FIRST_BLOCK_NODES, max_capacity);
+
+    if (current != nullptr)
+    {
+        capacity = std::min(current->capacity * 2, max_capacity);
+    }
+
+    void* memory = ::operator new(NODES_OFFSET + capacity * sizeof(NodeType));
+    current = ::new (memory) Block{current, capacity, 0};
+    block_count++;
+}
+
+
+
+#endif // NODEALLOCATOR_HPP
@@ -0,0 +1,114 @@
+// RollingHash.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "RollingHash.hpp"
+
+
+
+// Characters are converted to unsigned int the same way that the hash
+// policies in StringHashing.hpp convert them, so that the hashes agree
+// even for characters outside of ASCII.
+
+namespace
+{
+    unsigned int codeOf(char c) noexcept
+    {
+        return static_cast<unsigned int>(c);
+    }
+}
+
+
+
+RollingHash::RollingHash(unsigned int base)
+    : base{base}, length{0}, prefixes(1, 0), suffixes(1, 0), powers(2, 1), characters{}
+{
+    powers[1] = base;
+}
+
+
+void RollingHash::setWord(std::string_view word)
+{
+    length = word.size();
+
+    prefixes.resize(length + 1);
+    suffixes.resize(length + 1);
+    characters.resize(length);
+
+    // Insertions lengthen the word by one, so one more power is needed.
+    if (powers.size() < length + 2)
+    {
+        std::size_t known = powers.size();
+        powers.resize(length + 2);
+
+        for (std::size_t k = known; k < powers.size(); ++k)
+        {
+            powers[k] = powers[k - 1] * base;
+        }
+    }
+
+    prefixes[0] = 0;
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        characters[i] = codeOf(word[i]);
+        prefixes[i + 1] = prefixes[i] * base + characters[i];
+    }
+
+    suffixes[length] = 0;
+
+    for (std::size_t i = length; i > 0; --i)
+    {
+        suffixes[i - 1] = characters[i - 1] * powers[length - i] + suffixes[i];
+    }
+}
+
+
+unsigned int RollingHash::hash() const noexcept
+{
+    return prefixes[length];
+}
+
+
+unsigned int RollingHash::prefix(std::size_t i) const noexcept
+{
+    return prefixes[i];
+}
+
+
+unsigned int RollingHash::suffix(std::size_t i) const noexcept
+{
+    return suffixes[i];
+}
+
+
+unsigned int RollingHash::swapped(std::size_t i) const noexcept
+{
+    return prefixes[i] * powers[length - i]
+        + characters[i + 1] * powers[length - i - 1]
+        + characters[i] * powers[length - i - 2]
+        + suffixes[i + 2];
+}
+
+
+unsigned int RollingHash::inserted(std::size_t i, char c) const noexcept
+{
+    return prefixes[i] * powers[length - i + 1]
+        + codeOf(c) * powers[length - i]
+        + suffixes[i];
+}
+
+
+unsigned int RollingHash::deleted(std::size_t i) const noexcept
+{
+    return prefixes[i] * powers[length - i - 1] + suffixes[i + 1];
+}
+
+
+unsigned int RollingHash::replaced(std::size_t i, char c) const noexcept
+{
+    return prefixes[i] * powers[length - i]
+        + codeOf(c) * powers[length - i - 1]
+        + suffixes[i + 1];
+}
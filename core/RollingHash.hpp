@@ -0,0 +1,71 @@
+// RollingHash.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A RollingHash calculates the polynomial hashes of the strings one edit
+// away from a word, each in constant time.  The hash of the characters
+// c[0], c[1], ..., c[n - 1] is the sum of each c[i] times base^(n - 1 - i),
+// as an unsigned int (which is what ProductHashPolicy calculates, with a
+// base of 37), so the hash of any string made of a prefix of the word, a
+// character or two, and a suffix of the word can be put together from the
+// hashes of the prefix and the suffix, as long as each part is multiplied
+// by the right power of the base to shift it into place.
+//
+// setWord() calculates the hashes of every prefix and suffix of the word,
+// along with the powers of the base, in time linear in its length; after
+// that, every candidate's hash is a few multiplications and additions.
+
+#ifndef ROLLINGHASH_HPP
+#define ROLLINGHASH_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+
+
+class RollingHash
+{
+public:
+    explicit RollingHash(unsigned int base);
+
+    // setWord() prepares to hash the edits of the given word, whose
+    // characters are copied (so it needn't outlive the RollingHash).
+    void setWord(std::string_view word);
+
+    // hash() returns the hash of the word itself, prefix(i) the hash of
+    // its first i characters, and suffix(i) the hash of its characters
+    // from index i onward.
+    unsigned int hash() const noexcept;
+    unsigned int prefix(std::size_t i) const noexcept;
+    unsigned int suffix(std::size_t i) const noexcept;
+
+    // Each of these returns the hash of the word after one edit:
+    //
+    //   * swapped(i) swaps the characters at indexes i and i + 1
+    //   * inserted(i, c) inserts c before the character at index i (or,
+    //     when i is the length of the word, after the last one)
+    //   * deleted(i) deletes the character at index i
+    //   * replaced(i, c) replaces the character at index i with c
+    unsigned int swapped(std::size_t i) const noexcept;
+    unsigned int inserted(std::size_t i, char c) const noexcept;
+    unsigned int deleted(std::size_t i) const noexcept;
+    unsigned int replaced(std::size_t i, char c) const noexcept;
+
+private:
+    unsigned int base;
+    std::size_t length;
+
+    // prefixes[i] is the hash of the first i characters of the word and
+    // suffixes[i] the hash of the characters from index i onward, while
+    // powers[k] is base^k.
+    std::vector<unsigned int> prefixes;
+    std::vector<unsigned int> suffixes;
+    std::vector<unsigned int> powers;
+    std::vector<unsigned int> characters;
+};
+
+
+
+#endif // ROLLINGHASH_HPP
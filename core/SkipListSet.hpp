@@ -207,6 +207,9 @@ public:
     virtual void add(const ElementType& element) override;
 
 
+    using Set<ElementType>::contains;
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in an expected time of O(log n)
     // (i.e., over the long run, we expect the average to be O(log n))
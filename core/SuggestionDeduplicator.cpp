@@ -0,0 +1,96 @@
+// SuggestionDeduplicator.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <utility>
+#include "SuggestionDeduplicator.hpp"
+#include "StringHashing.hpp"
+
+
+
+SuggestionDeduplicator::SuggestionDeduplicator()
+    : slots(DEFAULT_CAPACITY, Slot{0, 0, 0}), generation{1}, used{0}, duplicates{0}
+{
+}
+
+
+void SuggestionDeduplicator::reset() noexcept
+{
+    ++generation;
+    used = 0;
+    duplicates = 0;
+
+    // On the (very) rare occasion that the generation wraps around, stale
+    // slots could look current again, so they're cleared out for real.
+    if (generation == 0)
+    {
+        for (Slot& slot : slots)
+        {
+            slot.generation = 0;
+        }
+
+        generation = 1;
+    }
+}
+
+
+bool SuggestionDeduplicator::addIfNew(std::string_view candidate, std::vector<std::string>& suggestions)
+{
+    // The table is kept at most half full, so probe sequences stay short.
+    if ((used + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+
+    std::uint64_t fingerprint = hashStringAsFnv1a64(candidate);
+    std::size_t mask = slots.size() - 1;
+
+    for (std::size_t i = fingerprint & mask; ; i = (i + 1) & mask)
+    {
+        Slot& slot = slots[i];
+
+        if (slot.generation != generation)
+        {
+            slot = Slot{fingerprint, generation, static_cast<std::uint32_t>(suggestions.size())};
+            ++used;
+            suggestions.emplace_back(candidate);
+            return true;
+        }
+        else if (slot.fingerprint == fingerprint && suggestions[slot.index] == candidate)
+        {
+            ++duplicates;
+            return false;
+        }
+    }
+}
+
+
+unsigned int SuggestionDeduplicator::duplicatesSuppressed() const noexcept
+{
+    return duplicates;
+}
+
+
+void SuggestionDeduplicator::grow()
+{
+    std::vector<Slot> oldSlots = std::move(slots);
+    slots.assign(oldSlots.size() * 2, Slot{0, 0, 0});
+
+    std::size_t mask = slots.size() - 1;
+
+    for (const Slot& old : oldSlots)
+    {
+        if (old.generation == generation)
+        {
+            std::size_t i = old.fingerprint & mask;
+
+            while (slots[i].generation == generation)
+            {
+                i = (i + 1) & mask;
+            }
+
+            slots[i] = old;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// SuggestionDeduplicator.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SuggestionDeduplicator keeps track of which suggestions have already
+// been added to a vector of suggestions, so that a word reached by more
+// than one edit is only suggested once, while the suggestions stay in the
+// order they were first found.
+//
+// It's a small open-addressing hash table of 64-bit fingerprints, each
+// paired with the index of its suggestion in the vector (so a matching
+// fingerprint is confirmed by comparing the strings).  Starting a new
+// word doesn't clear the table; instead, each slot is stamped with the
+// "generation" it was filled in, and slots from earlier generations count
+// as empty.  That way, one deduplicator can be reused across many words
+// without any allocation once its table is large enough.
+
+#ifndef SUGGESTIONDEDUPLICATOR_HPP
+#define SUGGESTIONDEDUPLICATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+class SuggestionDeduplicator
+{
+public:
+    // The number of slots in the table before it has had to grow.
+    static constexpr unsigned int DEFAULT_CAPACITY = 64;
+
+public:
+    SuggestionDeduplicator();
+
+    // reset() forgets all of the suggestions seen so far, in preparation
+    // for a new vector of suggestions.  This runs in constant time.
+    void reset() noexcept;
+
+    // addIfNew() appends the candidate to the suggestions and returns true,
+    // unless it's already been added since the last reset(), in which case
+    // it returns false and counts a suppressed duplicate.
+    bool addIfNew(std::string_view candidate, std::vector<std::string>& suggestions);
+
+    // duplicatesSuppressed() returns the number of times addIfNew() has
+    // returned false since the last reset().
+    unsigned int duplicatesSuppressed() const noexcept;
+
+private:
+    struct Slot
+    {
+        std::uint64_t fingerprint;
+        std::uint32_t generation;
+        std::uint32_t index;
+    };
+
+    std::vector<Slot> slots;
+    std::uint32_t generation;
+    unsigned int used;
+    unsigned int duplicates;
+
+    void grow();
+};
+
+
+
+#endif // SUGGESTIONDEDUPLICATOR_HPP
@@ -0,0 +1,136 @@
+// SuggestionIndex.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "SuggestionIndex.hpp"
+
+
+
+SuggestionIndex::SuggestionIndex()
+    : wordStarts{0}, bucketMask{0}
+{
+}
+
+
+void SuggestionIndex::add(std::string_view word)
+{
+    pool.append(word);
+    wordStarts.push_back(static_cast<std::uint32_t>(pool.size()));
+}
+
+
+// The index is laid out like a hash table whose buckets are stored one
+// after another: bucketWords holds the IDs of the words filed in bucket b
+// from bucketWords[bucketStarts[b]] up to bucketWords[bucketStarts[b + 1]].
+// It's built with a counting sort: one pass counts the entries that land
+// in each bucket, and a second pass drops each entry into its place.
+
+void SuggestionIndex::build()
+{
+    std::uint32_t words = wordCount();
+    std::size_t entries = 0;
+
+    for (std::uint32_t id = 0; id < words; ++id)
+    {
+        entries += variantCount(wordAt(id));
+    }
+
+    std::size_t bucketCount = 1;
+
+    while (bucketCount < entries)
+    {
+        bucketCount *= 2;
+    }
+
+    bucketMask = bucketCount - 1;
+    bucketStarts.assign(bucketCount + 1, 0);
+
+    std::vector<std::uint32_t> entryBuckets;
+    entryBuckets.reserve(entries);
+
+    std::string buffer;
+
+    for (std::uint32_t id = 0; id < words; ++id)
+    {
+        std::string_view word = wordAt(id);
+        buffer.resize(word.size());
+
+        forEachVariant(
+            word, buffer.data(),
+            [&](std::string_view variant)
+            {
+                std::uint32_t bucket = static_cast<std::uint32_t>(hashStringAsFnv1a64(variant) & bucketMask);
+                entryBuckets.push_back(bucket);
+                bucketStarts[bucket + 1]++;
+            });
+    }
+
+    for (std::size_t b = 0; b < bucketCount; ++b)
+    {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+
+    std::vector<std::uint32_t> next(bucketStarts.begin(), bucketStarts.end() - 1);
+    bucketWords.resize(entries);
+
+    std::size_t entry = 0;
+
+    for (std::uint32_t id = 0; id < words; ++id)
+    {
+        for (std::size_t v = variantCount(wordAt(id)); v > 0; --v)
+        {
+            bucketWords[next[entryBuckets[entry++]]++] = id;
+        }
+    }
+}
+
+
+bool SuggestionIndex::isBuilt() const noexcept
+{
+    return !bucketStarts.empty();
+}
+
+
+unsigned int SuggestionIndex::wordCount() const noexcept
+{
+    return static_cast<unsigned int>(wordStarts.size() - 1);
+}
+
+
+unsigned int SuggestionIndex::entryCount() const noexcept
+{
+    return static_cast<unsigned int>(bucketWords.size());
+}
+
+
+std::size_t SuggestionIndex::memoryUsage() const noexcept
+{
+    return sizeof(SuggestionIndex)
+        + pool.capacity()
+        + wordStarts.capacity() * sizeof(std::uint32_t)
+        + bucketStarts.capacity() * sizeof(std::uint32_t)
+        + bucketWords.capacity() * sizeof(std::uint32_t);
+}
+
+
+std::string_view SuggestionIndex::wordAt(std::uint32_t id) const noexcept
+{
+    return std::string_view{pool}.substr(wordStarts[id], wordStarts[id + 1] - wordStarts[id]);
+}
+
+
+std::size_t SuggestionIndex::variantCount(std::string_view word) noexcept
+{
+    std::size_t count = 1;
+
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        if (i == 0 || word[i] != word[i - 1])
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
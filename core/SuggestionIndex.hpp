@@ -0,0 +1,176 @@
+// SuggestionIndex.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SuggestionIndex is a precomputed "symmetric delete" index over a list
+// of words, which makes it possible to find the words within one edit of
+// a misspelled word with a handful of lookups, rather than by trying every
+// possible edit against the dictionary.
+//
+// The idea is that if two words are one insertion, deletion, replacement,
+// or adjacent swap apart, then deleting (at most) one character from each
+// of them produces the same string.  So, when the index is built, each word
+// is filed under itself and under every string that results from deleting
+// one of its characters.  To find the neighbors of a misspelled word, the
+// same variants of it are looked up, and every word filed under any of
+// them is a possible neighbor.
+//
+// Only hashes of the variants are stored, not the variants themselves, and
+// some words filed under a variant are two edits away rather than one, so
+// the neighbors that findNeighbors() reports are candidates that callers
+// need to verify (e.g., with EditCandidateGenerator::locate()); it may also
+// report the same word more than once.  What's guaranteed is that every
+// word within one edit is reported.
+//
+// Building the index is done in two steps: add() each word, then build().
+
+#ifndef SUGGESTIONINDEX_HPP
+#define SUGGESTIONINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "StringHashing.hpp"
+
+
+
+class SuggestionIndex
+{
+public:
+    SuggestionIndex();
+
+    // add() adds a word to the index.  It can't be called after build().
+    void add(std::string_view word);
+
+    // build() builds the index from the words that have been added.  Until
+    // it's been called, findNeighbors() finds nothing.
+    void build();
+
+    // isBuilt() returns true if build() has been called.
+    bool isBuilt() const noexcept;
+
+    // wordCount() returns the number of words added to the index.
+    unsigned int wordCount() const noexcept;
+
+    // entryCount() returns the number of (variant, word) pairs filed in
+    // the index.
+    unsigned int entryCount() const noexcept;
+
+    // memoryUsage() returns the approximate number of bytes of memory
+    // occupied by the index.
+    std::size_t memoryUsage() const noexcept;
+
+    // findNeighbors() calls visit(candidate) for each word filed under the
+    // given word or any of its one-character deletions.
+    template <typename VisitFunction>
+    void findNeighbors(std::string_view word, VisitFunction&& visit) const;
+
+
+private:
+    std::string pool;
+    std::vector<std::uint32_t> wordStarts;
+
+    std::vector<std::uint32_t> bucketStarts;
+    std::vector<std::uint32_t> bucketWords;
+    std::uint64_t bucketMask;
+
+    std::string_view wordAt(std::uint32_t id) const noexcept;
+
+    template <typename VisitFunction>
+    void visitBucket(std::string_view variant, VisitFunction& visit) const;
+
+    // forEachVariant() calls visit(variant) with the word itself and then each
+    // distinct one-character deletion of it, which are built in the given
+    // buffer (of at least word.size() characters).  Deleting any character
+    // in a run of equal characters gives the same result, so only the first
+    // in each run is deleted.
+    template <typename VisitFunction>
+    static void forEachVariant(std::string_view word, char* buffer, VisitFunction&& visit);
+
+    // variantCount() returns the number of variants forEachVariant() visits.
+    static std::size_t variantCount(std::string_view word) noexcept;
+};
+
+
+
+template <typename VisitFunction>
+void SuggestionIndex::findNeighbors(std::string_view word, VisitFunction&& visit) const
+{
+    if (!isBuilt())
+    {
+        return;
+    }
+
+    // Most words fit in a buffer on the stack, so no allocation is needed;
+    // longer ones fall back to a std::string.
+    char stackBuffer[64];
+    std::string longBuffer;
+    char* buffer = stackBuffer;
+
+    if (word.size() > sizeof(stackBuffer))
+    {
+        longBuffer.resize(word.size());
+        buffer = longBuffer.data();
+    }
+
+    forEachVariant(
+        word, buffer,
+        [&](std::string_view variant)
+        {
+            visitBucket(variant, visit);
+        });
+}
+
+
+template <typename VisitFunction>
+void SuggestionIndex::visitBucket(std::string_view variant, VisitFunction& visit) const
+{
+    std::uint64_t bucket = hashStringAsFnv1a64(variant) & bucketMask;
+
+    for (std::uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; ++i)
+    {
+        std::string_view candidate = wordAt(bucketWords[i]);
+
+        // The words filed under a variant are either the variant itself or
+        // one character longer; any others are there because some other
+        // variant landed in the same bucket.
+        if (candidate.size() == variant.size() || candidate.size() == variant.size() + 1)
+        {
+            visit(candidate);
+        }
+    }
+}
+
+
+template <typename VisitFunction>
+void SuggestionIndex::forEachVariant(std::string_view word, char* buffer, VisitFunction&& visit)
+{
+    visit(word);
+
+    if (word.empty())
+    {
+        return;
+    }
+
+    word.copy(buffer, word.size() - 1, 1);
+
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        if (i == 0 || word[i] != word[i - 1])
+        {
+            visit(std::string_view{buffer, word.size() - 1});
+        }
+
+        if (i + 1 < word.size())
+        {
+            buffer[i] = word[i];
+        }
+    }
+}
+
+
+
+#endif // SUGGESTIONINDEX_HPP
@@ -0,0 +1,93 @@
+// ThreadPool.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <utility>
+#include "ThreadPool.hpp"
+
+
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : stopping{false}
+{
+    if (threadCount == 0)
+    {
+        threadCount = 1;
+    }
+
+    threads.reserve(threadCount);
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([this] { work(); });
+    }
+}
+
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    taskAvailable.notify_all();
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask{std::move(task)};
+    std::future<void> future = packagedTask.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        tasks.push_back(std::move(packagedTask));
+    }
+
+    taskAvailable.notify_one();
+    return future;
+}
+
+
+unsigned int ThreadPool::threadCount() const noexcept
+{
+    return static_cast<unsigned int>(threads.size());
+}
+
+
+unsigned int ThreadPool::defaultThreadCount() noexcept
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,62 @@
+// ThreadPool.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ThreadPool is a fixed set of worker threads that run tasks submitted
+// to it, in the order they were submitted (though, with more than one
+// thread, tasks can finish in any order).  Submitting a task returns a
+// std::future that becomes ready when the task finishes; if the task
+// throws an exception, calling get() on the future rethrows it.
+//
+// Destroying a ThreadPool waits for all of the tasks already submitted to
+// finish before the threads are joined.
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+class ThreadPool
+{
+public:
+    // Starts the given number of worker threads (at least one).
+    explicit ThreadPool(unsigned int threadCount);
+
+    // Waits for the submitted tasks to finish, then stops the threads.
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // submit() queues a task to be run by one of the worker threads.
+    std::future<void> submit(std::function<void()> task);
+
+    // threadCount() returns the number of worker threads.
+    unsigned int threadCount() const noexcept;
+
+    // defaultThreadCount() returns the number of threads the hardware can
+    // run at once, or 1 if that can't be determined.
+    static unsigned int defaultThreadCount() noexcept;
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::packaged_task<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    bool stopping;
+
+    void work();
+};
+
+
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,185 @@
+// TrieSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <utility>
+#include "TrieSet.hpp"
+
+
+
+TrieSet::TrieSet()
+    : root{new Node{'\0', false, nullptr, nullptr}}, current_size{0}
+{
+}
+
+
+TrieSet::~TrieSet() noexcept
+{
+    if (root != nullptr)
+    {
+        destroyChildren(root->firstChild);
+        delete root;
+    }
+}
+
+
+TrieSet::TrieSet(const TrieSet& s)
+    : root{new Node{'\0', s.root->isWord, nullptr, nullptr}}, current_size{s.current_size}
+{
+    try
+    {
+        root->firstChild = copyChildren(s.root->firstChild);
+    }
+    catch (...)
+    {
+        delete root;
+        throw;
+    }
+}
+
+
+TrieSet::TrieSet(TrieSet&& s) noexcept
+    : TrieSet{}
+{
+    std::swap(root, s.root);
+    std::swap(current_size, s.current_size);
+}
+
+
+TrieSet& TrieSet::operator=(const TrieSet& s)
+{
+    if (this != &s)
+    {
+        TrieSet copy{s};
+        std::swap(root, copy.root);
+        std::swap(current_size, copy.current_size);
+    }
+
+    return *this;
+}
+
+
+TrieSet& TrieSet::operator=(TrieSet&& s) noexcept
+{
+    std::swap(root, s.root);
+    std::swap(current_size, s.current_size);
+    return *this;
+}
+
+
+bool TrieSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void TrieSet::add(const std::string& element)
+{
+    Node* node = root;
+
+    for (char c : element)
+    {
+        Node** link = &node->firstChild;
+
+        while (*link != nullptr && (*link)->label < c)
+        {
+            link = &(*link)->nextSibling;
+        }
+
+        if (*link == nullptr || (*link)->label != c)
+        {
+            *link = new Node{c, false, nullptr, *link};
+        }
+
+        node = *link;
+    }
+
+    if (!node->isWord)
+    {
+        node->isWord = true;
+        current_size++;
+    }
+}
+
+
+bool TrieSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool TrieSet::contains(std::string_view element) const
+{
+    const Node* node = find(element);
+    return node != nullptr && node->isWord;
+}
+
+
+unsigned int TrieSet::size() const noexcept
+{
+    return current_size;
+}
+
+
+const TrieSet::Node* TrieSet::find(std::string_view element) const
+{
+    const Node* node = root;
+
+    for (char c : element)
+    {
+        node = node->firstChild;
+
+        while (node != nullptr && node->label < c)
+        {
+            node = node->nextSibling;
+        }
+
+        if (node == nullptr || node->label != c)
+        {
+            return nullptr;
+        }
+    }
+
+    return node;
+}
+
+
+// copyChildren() returns a copy of the given list of siblings, along with
+// everything beneath them.  If an allocation fails partway through, what's
+// been copied so far is destroyed.
+
+TrieSet::Node* TrieSet::copyChildren(const Node* first)
+{
+    Node* copy = nullptr;
+    Node** link = &copy;
+
+    try
+    {
+        for (const Node* node = first; node != nullptr; node = node->nextSibling)
+        {
+            *link = new Node{node->label, node->isWord, nullptr, nullptr};
+            (*link)->firstChild = copyChildren(node->firstChild);
+            link = &(*link)->nextSibling;
+        }
+
+        return copy;
+    }
+    catch (...)
+    {
+        destroyChildren(copy);
+        throw;
+    }
+}
+
+
+void TrieSet::destroyChildren(Node* first) noexcept
+{
+    while (first != nullptr)
+    {
+        Node* next = first->nextSibling;
+        destroyChildren(first->firstChild);
+        delete first;
+        first = next;
+    }
+}
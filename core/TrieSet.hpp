@@ -0,0 +1,143 @@
+// TrieSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A TrieSet is an implementation of a Set of strings that is a trie: a tree
+// in which each node represents a prefix of the words in the set, and each
+// child of a node extends that prefix by one character.  A node is marked
+// if its prefix is one of the words.  Words with a common prefix share the
+// nodes for it, so add() and contains() take time proportional to the
+// length of the word (times the number of distinct characters that can
+// follow a prefix, since each node's children are kept in a linked list
+// sorted by character).
+//
+// Because every word sharing a prefix lives beneath one node, a TrieSet can
+// also find all of the words within a few edits of a given word in a single
+// walk of the tree, using a LevenshteinAutomaton to decide which subtrees
+// could possibly contain a match and skipping the rest.
+
+#ifndef TRIESET_HPP
+#define TRIESET_HPP
+
+#include <string>
+#include <string_view>
+#include "LevenshteinAutomaton.hpp"
+#include "Set.hpp"
+
+
+
+class TrieSet : public Set<std::string>
+{
+public:
+    // Initializes a TrieSet to be empty.
+    TrieSet();
+
+    // Cleans up the TrieSet so that it leaks no memory.
+    virtual ~TrieSet() noexcept;
+
+    // Initializes a new TrieSet to be a copy of an existing one.
+    TrieSet(const TrieSet& s);
+
+    // Initializes a new TrieSet whose contents are moved from an
+    // expiring one.
+    TrieSet(TrieSet&& s) noexcept;
+
+    // Assigns an existing TrieSet into another.
+    TrieSet& operator=(const TrieSet& s);
+
+    // Assigns an expiring TrieSet into another.
+    TrieSet& operator=(TrieSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.
+    virtual void add(const std::string& element) override;
+
+
+    using Set<std::string>::contains;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.
+    virtual bool contains(const std::string& element) const override;
+    virtual bool contains(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // findWithinDistance() calls visit(word, distance) for each word in the
+    // set whose edit distance from the given word (counting insertions,
+    // deletions, replacements, and adjacent swaps) is at most maxDistance,
+    // which can be at most LevenshteinAutomaton::MAX_DISTANCE.  The words
+    // are visited in ascending order, as std::string_views that are only
+    // valid during the call to visit.
+    template <typename VisitFunction>
+    void findWithinDistance(std::string_view word, unsigned int maxDistance, VisitFunction&& visit) const;
+
+
+private:
+    struct Node
+    {
+        char label;
+        bool isWord;
+        Node* firstChild;
+        Node* nextSibling;
+    };
+
+    Node* root;
+    unsigned int current_size;
+
+    const Node* find(std::string_view element) const;
+    static Node* copyChildren(const Node* first);
+    static void destroyChildren(Node* first) noexcept;
+
+    template <typename VisitFunction>
+    static void walk(const Node* node, LevenshteinAutomaton& automaton, VisitFunction& visit);
+};
+
+
+
+template <typename VisitFunction>
+void TrieSet::findWithinDistance(std::string_view word, unsigned int maxDistance, VisitFunction&& visit) const
+{
+    LevenshteinAutomaton automaton{word, maxDistance};
+
+    if (root->isWord && automaton.isMatch())
+    {
+        visit(automaton.current(), automaton.distance());
+    }
+
+    walk(root, automaton, visit);
+}
+
+
+template <typename VisitFunction>
+void TrieSet::walk(const Node* node, LevenshteinAutomaton& automaton, VisitFunction& visit)
+{
+    for (const Node* child = node->firstChild; child != nullptr; child = child->nextSibling)
+    {
+        automaton.push(child->label);
+
+        if (automaton.canMatch())
+        {
+            if (child->isWord && automaton.isMatch())
+            {
+                visit(automaton.current(), automaton.distance());
+            }
+
+            walk(child, automaton, visit);
+        }
+
+        automaton.pop();
+    }
+}
+
+
+
+#endif // TRIESET_HPP
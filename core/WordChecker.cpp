@@ -7,113 +7,241 @@
 // the requirements.
 
 #include "WordChecker.hpp"
+#include <algorithm>
 #include <utility>
 #include <string>
+#include <string_view>
 
 
 WordChecker::WordChecker(const Set<std::string>& words)
-    : words{words}
+	: words{words}, index{nullptr}, rollingHash{words.rollingHashBase()}, prefilter{nullptr}
+{
+}
+
+
+WordChecker::WordChecker(const Set<std::string>& words, const SuggestionIndex& index)
+	: words{words}, index{&index}, rollingHash{words.rollingHashBase()}, prefilter{nullptr}
 {
 }
 
 
 bool WordChecker::wordExists(const std::string& word) const
 {
-    return words.contains(word);
+	return words.contains(word);
 }
 
 
-std::vector<std::string> WordChecker::findSuggestions(const std::string& word) const
+bool WordChecker::wordExists(std::string_view word) const
 {
-	std::vector<std::string> suggestions;
-	std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	return words.contains(word);
+}
+
+
+bool WordChecker::candidateExists(std::string_view candidate) const
+{
+	return !prefilterRejects(candidate) && confirmPrefilter(words.contains(candidate));
+}
 
-	swapAdjacent(word, suggestions);
-	insertChar(word, suggestions, alphabet);
-	deleteChar(word, suggestions);
-	replaceChar(word, suggestions, alphabet);
-	splitWord(word, suggestions);
 
-    return suggestions;
+bool WordChecker::candidateExists(std::string_view candidate, unsigned int hash) const
+{
+	return !prefilterRejects(candidate) && confirmPrefilter(words.containsHashed(hash, candidate));
 }
 
 
-void WordChecker::swapAdjacent(const std::string& word, std::vector<std::string>& suggestions) const
+bool WordChecker::prefilterRejects(std::string_view candidate) const
 {
-	for (int i = 0; i < word.size() - 1; ++i)
+	if (prefilter == nullptr)
 	{
-		std::string temp = word;
-		std::swap(temp[i], temp[i + 1]);
+		return false;
+	}
 
-		if (wordExists(temp) && notContains(temp, suggestions))
-		{
-			suggestions.push_back(temp);
-		}
+	++filterStats.lookups;
+
+	if (!prefilter->mightContain(candidate))
+	{
+		++filterStats.rejected;
+		return true;
 	}
+
+	return false;
 }
 
-void WordChecker::insertChar(const std::string& word, std::vector<std::string>& suggestions, const std::string& alphabet) const
+
+bool WordChecker::confirmPrefilter(bool exists) const
 {
-	for (int i = 0; i < word.size() + 1; ++i)
+	if (prefilter != nullptr && !exists)
 	{
-		for (int j = 0; j < alphabet.size(); ++j)
-		{
-			std::string temp = word;
-			temp.insert(i, alphabet.substr(j, 1));
+		++filterStats.falsePositives;
+	}
 
-			if (wordExists(temp) && notContains(temp, suggestions))
+	return exists;
+}
+
+
+std::vector<std::string> WordChecker::findSuggestions(const std::string& word) const
+{
+	std::vector<std::string> suggestions;
+	EditCandidateGenerator generator;
+
+	deduplicator.reset();
+	lastStats = SuggestionStats{};
+
+	auto visit =
+		[&](EditKind kind, std::string_view candidate)
+		{
+			if (kind == EditKind::Split)
 			{
-				suggestions.push_back(temp);
+				addSplitSuggestion(candidate, suggestions);
 			}
-		}
+			else
+			{
+				addSuggestion(candidate, suggestions);
+			}
+		};
+
+	if (index != nullptr && index->isBuilt())
+	{
+		addIndexedSuggestions(word, generator, suggestions);
+		generator.generateSplits(word, visit);
+	}
+	else if (words.rollingHashBase() != 0)
+	{
+		rollingHash.setWord(word);
+
+		generator.generate(
+			word,
+			[&](EditKind /* kind */, std::string_view candidate, const CandidatePosition& position)
+			{
+				addHashedSuggestion(position, candidate, suggestions);
+			});
+	}
+	else
+	{
+		generator.generate(word, visit);
 	}
+
+	lastStats.duplicatesSuppressed = deduplicator.duplicatesSuppressed();
+
+	return suggestions;
+}
+
+
+const SuggestionStats& WordChecker::lastSuggestionStats() const noexcept
+{
+	return lastStats;
+}
+
+
+void WordChecker::usePrefilter(const BloomFilter& filter)
+{
+	prefilter = &filter;
+	filterStats = PrefilterStats{};
 }
 
-void WordChecker::deleteChar(const std::string& word, std::vector<std::string>& suggestions) const 
+
+const PrefilterStats& WordChecker::prefilterStats() const noexcept
+{
+	return filterStats;
+}
+
+
+void WordChecker::addSuggestion(std::string_view candidate, std::vector<std::string>& suggestions) const
 {
-	for (int i = 0; i < word.size(); ++i)
+	if (candidateExists(candidate))
 	{
-		std::string temp = word;
-		temp.erase(i, 1);
-		if (wordExists(temp) && notContains(temp, suggestions))
-		{
-			suggestions.push_back(temp);
-		}
+		++lastStats.hits;
+		deduplicator.addIfNew(candidate, suggestions);
 	}
 }
 
-void WordChecker::replaceChar(const std::string& word, std::vector<std::string>& suggestions, const std::string& alphabet) const
+
+void WordChecker::addSplitSuggestion(std::string_view candidate, std::vector<std::string>& suggestions) const
 {
-	for (int i = 0; i < word.size(); ++i)
-	{
-		std::string temp = word;
+	std::size_t space = candidate.find(' ');
 
-		for (int j = 0; j < alphabet.size(); ++j)
-		{
-			temp.replace(i, 1, alphabet.substr(j, 1));
-			if (wordExists(temp) && notContains(temp, suggestions))
-			{
-				suggestions.push_back(temp);
-			}
-		}
+	if (candidateExists(candidate.substr(0, space)) && candidateExists(candidate.substr(space + 1)))
+	{
+		++lastStats.hits;
+		deduplicator.addIfNew(candidate, suggestions);
 	}
 }
 
-void WordChecker::splitWord(const std::string& word, std::vector<std::string>& suggestions) const
+
+void WordChecker::addHashedSuggestion(
+	const CandidatePosition& position, std::string_view candidate,
+	std::vector<std::string>& suggestions) const
 {
-	for (int i = 1; i < word.size(); ++i)
+	std::size_t i = position.index;
+	bool exists = false;
+
+	switch (position.kind)
 	{
-		std::string left = word.substr(0, i);
-		std::string right = word.substr(i);
+	case EditKind::Swap:
+		exists = candidateExists(candidate, rollingHash.swapped(i));
+		break;
+
+	case EditKind::Insert:
+		exists = candidateExists(candidate, rollingHash.inserted(i, candidate[i]));
+		break;
+
+	case EditKind::Delete:
+		exists = candidateExists(candidate, rollingHash.deleted(i));
+		break;
+
+	case EditKind::Replace:
+		exists = candidateExists(candidate, rollingHash.replaced(i, candidate[i]));
+		break;
+
+	case EditKind::Split:
+		// The candidate is the first i characters, a space, and the rest.
+		exists =
+			candidateExists(candidate.substr(0, i), rollingHash.prefix(i))
+			&& candidateExists(candidate.substr(i + 1), rollingHash.suffix(i));
+		break;
+	}
 
-		if (wordExists(left) && wordExists(right) && notContains(left + " " + right, suggestions))
-		{
-			suggestions.push_back(left + " " + right);
-		}
+	if (exists)
+	{
+		++lastStats.hits;
+		deduplicator.addIfNew(candidate, suggestions);
 	}
 }
 
-bool WordChecker::notContains(const std::string& word, std::vector<std::string>& suggestions) const
+
+void WordChecker::addIndexedSuggestions(
+	const std::string& word, const EditCandidateGenerator& generator,
+	std::vector<std::string>& suggestions) const
 {
-	return std::find(suggestions.begin(), suggestions.end(), word) == suggestions.end();
-}
\ No newline at end of file
+	neighbors.clear();
+
+	index->findNeighbors(
+		word,
+		[&](std::string_view candidate)
+		{
+			CandidatePosition position;
+
+			if (generator.locate(word, candidate, position))
+			{
+				neighbors.emplace_back(position, candidate);
+			}
+		});
+
+	// The same word can be found under more than one variant; those copies
+	// have the same position, so they end up next to each other.
+	std::sort(
+		neighbors.begin(), neighbors.end(),
+		[](const auto& a, const auto& b) { return a.first < b.first; });
+
+	neighbors.erase(
+		std::unique(
+			neighbors.begin(), neighbors.end(),
+			[](const auto& a, const auto& b) { return !(a.first < b.first) && !(b.first < a.first); }),
+		neighbors.end());
+
+	for (const auto& neighbor : neighbors)
+	{
+		++lastStats.hits;
+		deduplicator.addIfNew(neighbor.second, suggestions);
+	}
+}
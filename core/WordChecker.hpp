@@ -12,13 +12,65 @@
 // given.
 //
 // You are permitted to use the C++ Standard Library in this class.
+//
+// A WordChecker reuses some internal state from one call to findSuggestions()
+// to the next, so a single WordChecker shouldn't be used by more than one
+// thread at a time (though any number of WordCheckers can share a Set).
+//
+// When the Set finds words by a rolling hash (see Set::rollingHashBase()),
+// the candidates' hashes are calculated incrementally by a RollingHash,
+// each in constant time, and handed to the Set along with the candidates,
+// so that it needn't hash each one from scratch.
+//
+// A WordChecker can also be given a BloomFilter built from the same words,
+// which is asked about each candidate before the Set is; the candidates it
+// rules out (nearly all of them, since most aren't words) never reach the
+// Set at all.
 
 #ifndef WORDCHECKER_HPP
 #define WORDCHECKER_HPP
 
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include "BloomFilter.hpp"
+#include "EditCandidateGenerator.hpp"
+#include "RollingHash.hpp"
 #include "Set.hpp"
+#include "SuggestionDeduplicator.hpp"
+#include "SuggestionIndex.hpp"
+
+
+
+// SuggestionStats describes the work done by the most recent call to
+// WordChecker::findSuggestions().
+
+struct SuggestionStats
+{
+    // The number of candidates that turned out to be words.
+    unsigned int hits = 0;
+
+    // The number of those hits that were already among the suggestions.
+    unsigned int duplicatesSuppressed = 0;
+};
+
+
+
+// PrefilterStats describes the work done by a WordChecker's BloomFilter,
+// totaled over every call to findSuggestions() since it was given one.
+
+struct PrefilterStats
+{
+    // The number of candidates that the filter was asked about.
+    unsigned long long lookups = 0;
+
+    // The number of those that the filter ruled out.
+    unsigned long long rejected = 0;
+
+    // The number that the filter didn't rule out, but that weren't words.
+    unsigned long long falsePositives = 0;
+};
 
 
 
@@ -31,9 +83,17 @@ public:
     WordChecker(const Set<std::string>& words);
 
 
+    // This constructor also takes a SuggestionIndex built from the same
+    // words, which findSuggestions() will use to find words within one
+    // edit, rather than trying every edit against the Set.  The suggestions
+    // are the same either way, and in the same order.
+    WordChecker(const Set<std::string>& words, const SuggestionIndex& index);
+
+
     // wordExists() returns true if the given word is spelled correctly,
     // false otherwise.
     bool wordExists(const std::string& word) const;
+    bool wordExists(std::string_view word) const;
 
 
     // findSuggestions() returns a vector containing suggested alternative
@@ -42,16 +102,69 @@ public:
     std::vector<std::string> findSuggestions(const std::string& word) const;
 
 
-private:
-    const Set<std::string>& words;
+    // lastSuggestionStats() returns statistics about the most recent call
+    // to findSuggestions().
+    const SuggestionStats& lastSuggestionStats() const noexcept;
+
+
+    // usePrefilter() has the WordChecker ask the given BloomFilter, which
+    // must have been built from the same words as the Set, about each
+    // candidate before asking the Set.  The filter is not copied, so it
+    // must outlive the WordChecker (and any copies of it).
+    void usePrefilter(const BloomFilter& filter);
+
 
-    void swapAdjacent(const std::string& word, std::vector<std::string>& suggestions) const;
-    void insertChar(const std::string& word, std::vector<std::string>& suggestions, const std::string& alphabet) const;
-    void deleteChar(const std::string& word, std::vector<std::string>& suggestions) const;
-    void replaceChar(const std::string& word, std::vector<std::string>& suggestions, const std::string& alphabet) const;
-    void splitWord(const std::string& word, std::vector<std::string>& suggestions) const;
+    // prefilterStats() returns statistics about the BloomFilter's work
+    // since usePrefilter() was called.
+    const PrefilterStats& prefilterStats() const noexcept;
 
-    bool notContains(const std::string& word, std::vector<std::string>& suggestions) const;
+
+private:
+    const Set<std::string>& words;
+    const SuggestionIndex* index;
+
+    mutable SuggestionDeduplicator deduplicator;
+    mutable SuggestionStats lastStats;
+    mutable std::vector<std::pair<CandidatePosition, std::string_view>> neighbors;
+    mutable RollingHash rollingHash;
+
+    const BloomFilter* prefilter;
+    mutable PrefilterStats filterStats;
+
+    // candidateExists() is like wordExists(), but asks the Set about a
+    // std::string_view, so that candidates needn't be std::strings, and
+    // asks the prefilter (if any) first.  The second version passes the
+    // candidate's rolling hash along to the Set.
+    bool candidateExists(std::string_view candidate) const;
+    bool candidateExists(std::string_view candidate, unsigned int hash) const;
+
+    // prefilterRejects() returns true if the prefilter rules out the
+    // candidate, while confirmPrefilter() is given the Set's answer about
+    // a candidate that the prefilter didn't rule out, counting it as a
+    // false positive if need be, and returns it.
+    bool prefilterRejects(std::string_view candidate) const;
+    bool confirmPrefilter(bool exists) const;
+
+    // addSuggestion() adds the candidate to the suggestions if it's a word
+    // that isn't already there; addSplitSuggestion() does the same for a
+    // candidate made of two words separated by a space, both of which must
+    // exist.
+    void addSuggestion(std::string_view candidate, std::vector<std::string>& suggestions) const;
+    void addSplitSuggestion(std::string_view candidate, std::vector<std::string>& suggestions) const;
+
+    // addHashedSuggestion() is like addSuggestion() (or, for a split,
+    // addSplitSuggestion()), but finds the candidate's hash with the
+    // RollingHash, which must already have been given the word.
+    void addHashedSuggestion(
+        const CandidatePosition& position, std::string_view candidate,
+        std::vector<std::string>& suggestions) const;
+
+    // addIndexedSuggestions() adds the words within one edit of the given
+    // word, as found in the index, in the order the generator would have
+    // found them.
+    void addIndexedSuggestions(
+        const std::string& word, const EditCandidateGenerator& generator,
+        std::vector<std::string>& suggestions) const;
 
 
 
@@ -0,0 +1,389 @@
+// WordTokenizer.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <cstdint>
+#include "WordTokenizer.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define WORDTOKENIZER_HAS_AVX2 1
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+namespace
+{
+    bool isLetterOrDigit(char c) noexcept
+    {
+        unsigned char lowered = static_cast<unsigned char>(c) | 0x20;
+        return (c >= '0' && c <= '9') || (lowered >= 'a' && lowered <= 'z');
+    }
+
+
+    bool continuesWord(char c) noexcept
+    {
+        return isLetterOrDigit(c) || c == '-' || c == '\'';
+    }
+
+
+    unsigned int lowestBit(std::uint32_t mask) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+        unsigned int index = 0;
+
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            ++index;
+        }
+
+        return index;
+#endif
+    }
+
+
+    // finishWord() is where every implementation ends up once it has found
+    // both ends of a word: index is moved to the end, and if the word ends
+    // in a hyphen or apostrophe, exactly one of them is dropped.  (So
+    // "abc--" becomes "abc-"; this matches the single pop_back() that the
+    // original TextFileReader did.)
+    bool finishWord(
+        std::string_view text, std::size_t begin, std::size_t end,
+        std::size_t& index, std::size_t& start, std::size_t& length) noexcept
+    {
+        index = end;
+        start = begin;
+        length = end - begin;
+
+        if (!isLetterOrDigit(text[end - 1]))
+        {
+            --length;
+        }
+
+        return true;
+    }
+
+
+    bool nextWordScalar(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length) noexcept
+    {
+        std::size_t i = index;
+
+        while (i < text.size() && !isLetterOrDigit(text[i]))
+        {
+            ++i;
+        }
+
+        if (i >= text.size())
+        {
+            index = text.size();
+            return false;
+        }
+
+        std::size_t begin = i++;
+
+        while (i < text.size() && continuesWord(text[i]))
+        {
+            ++i;
+        }
+
+        return finishWord(text, begin, i, index, start, length);
+    }
+
+
+    // The vectorized implementations all have the same shape, differing only
+    // in how wide a block is and how its masks are computed: look for the
+    // first letter or digit a block at a time, then for the first character
+    // after it that can't continue the word, finishing any partial block at
+    // the end of the text one byte at a time (so nothing past the end of the
+    // text is ever read).
+
+    template <typename Classifier>
+    bool nextWordBlocked(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length) noexcept
+    {
+        constexpr std::size_t WIDTH = Classifier::WIDTH;
+
+        const char* data = text.data();
+        std::size_t size = text.size();
+        std::size_t i = index;
+        std::size_t begin = size;
+
+        for (; i + WIDTH <= size; i += WIDTH)
+        {
+            std::uint32_t letters = Classifier::lettersAndDigits(data + i);
+
+            if (letters != 0)
+            {
+                begin = i + lowestBit(letters);
+                break;
+            }
+        }
+
+        if (begin == size)
+        {
+            for (; i < size; ++i)
+            {
+                if (isLetterOrDigit(data[i]))
+                {
+                    begin = i;
+                    break;
+                }
+            }
+
+            if (begin == size)
+            {
+                index = size;
+                return false;
+            }
+        }
+
+        for (i = begin + 1; i + WIDTH <= size; i += WIDTH)
+        {
+            std::uint32_t stops = ~Classifier::wordCharacters(data + i) & Classifier::ALL;
+
+            if (stops != 0)
+            {
+                return finishWord(text, begin, i + lowestBit(stops), index, start, length);
+            }
+        }
+
+        while (i < size && continuesWord(data[i]))
+        {
+            ++i;
+        }
+
+        return finishWord(text, begin, i, index, start, length);
+    }
+
+
+#ifdef __SSE2__
+    // Since the ASCII letters and digits are all below 0x80, they can be
+    // found with signed comparisons: every byte from 0x80 up is negative,
+    // and so falls below every range.
+
+    struct SSE2Classifier
+    {
+        static constexpr std::size_t WIDTH = 16;
+        static constexpr std::uint32_t ALL = 0xFFFF;
+
+        static __m128i lettersAndDigitsVector(__m128i bytes) noexcept
+        {
+            __m128i lowered = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+
+            __m128i digits = _mm_and_si128(
+                _mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+
+            __m128i letters = _mm_and_si128(
+                _mm_cmpgt_epi8(lowered, _mm_set1_epi8('a' - 1)),
+                _mm_cmplt_epi8(lowered, _mm_set1_epi8('z' + 1)));
+
+            return _mm_or_si128(digits, letters);
+        }
+
+        static std::uint32_t lettersAndDigits(const char* block) noexcept
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(lettersAndDigitsVector(bytes)));
+        }
+
+        static std::uint32_t wordCharacters(const char* block) noexcept
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+
+            __m128i punctuation = _mm_or_si128(
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')),
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\'')));
+
+            return static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_or_si128(lettersAndDigitsVector(bytes), punctuation)));
+        }
+    };
+
+
+    bool nextWordSSE2(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length) noexcept
+    {
+        return nextWordBlocked<SSE2Classifier>(text, index, start, length);
+    }
+#endif
+
+
+#ifdef WORDTOKENIZER_HAS_AVX2
+    // The AVX2 functions are compiled for AVX2 regardless of the compiler's
+    // settings, but are only ever called when the processor supports it.
+    // nextWordAVX2() is flattened, so that the blocked loop and the
+    // classifier are inlined into it and compiled for AVX2 along with it.
+
+    struct AVX2Classifier
+    {
+        static constexpr std::size_t WIDTH = 32;
+        static constexpr std::uint32_t ALL = 0xFFFFFFFF;
+
+        __attribute__((target("avx2")))
+        static __m256i lettersAndDigitsVector(__m256i bytes) noexcept
+        {
+            __m256i lowered = _mm256_or_si256(bytes, _mm256_set1_epi8(0x20));
+
+            __m256i digits = _mm256_and_si256(
+                _mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)),
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), bytes));
+
+            __m256i letters = _mm256_and_si256(
+                _mm256_cmpgt_epi8(lowered, _mm256_set1_epi8('a' - 1)),
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lowered));
+
+            return _mm256_or_si256(digits, letters);
+        }
+
+        __attribute__((target("avx2")))
+        static std::uint32_t lettersAndDigits(const char* block) noexcept
+        {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(lettersAndDigitsVector(bytes)));
+        }
+
+        __attribute__((target("avx2")))
+        static std::uint32_t wordCharacters(const char* block) noexcept
+        {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+
+            __m256i punctuation = _mm256_or_si256(
+                _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('-')),
+                _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\'')));
+
+            return static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_or_si256(lettersAndDigitsVector(bytes), punctuation)));
+        }
+    };
+
+
+    __attribute__((target("avx2"), flatten))
+    bool nextWordAVX2(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length) noexcept
+    {
+        return nextWordBlocked<AVX2Classifier>(text, index, start, length);
+    }
+#endif
+}
+
+
+
+WordTokenizer::WordTokenizer()
+    : WordTokenizer{bestAvailable()}
+{
+}
+
+
+WordTokenizer::WordTokenizer(Implementation implementation)
+    : implementation_{implementation}, nextWordFunction{nextWordScalar}
+{
+    switch (implementation)
+    {
+    case Implementation::Scalar:
+        break;
+
+    case Implementation::SSE2:
+#ifdef __SSE2__
+        nextWordFunction = nextWordSSE2;
+#endif
+        break;
+
+    case Implementation::AVX2:
+#ifdef WORDTOKENIZER_HAS_AVX2
+        nextWordFunction = nextWordAVX2;
+#endif
+        break;
+    }
+
+    if (!isAvailable(implementation))
+    {
+        implementation_ = Implementation::Scalar;
+        nextWordFunction = nextWordScalar;
+    }
+}
+
+
+WordTokenizer::Implementation WordTokenizer::implementation() const noexcept
+{
+    return implementation_;
+}
+
+
+bool WordTokenizer::isAvailable(Implementation implementation) noexcept
+{
+    switch (implementation)
+    {
+    case Implementation::Scalar:
+        return true;
+
+    case Implementation::SSE2:
+#ifdef __SSE2__
+        return true;
+#else
+        return false;
+#endif
+
+    case Implementation::AVX2:
+#ifdef WORDTOKENIZER_HAS_AVX2
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+
+// Words in ordinary text are shorter than an SSE2 block, so the second half
+// of each block that AVX2 examines is usually wasted; on typical text, SSE2
+// comes out ahead, so it's preferred when it's available.
+
+WordTokenizer::Implementation WordTokenizer::bestAvailable() noexcept
+{
+    if (isAvailable(Implementation::SSE2))
+    {
+        return Implementation::SSE2;
+    }
+    else if (isAvailable(Implementation::AVX2))
+    {
+        return Implementation::AVX2;
+    }
+    else
+    {
+        return Implementation::Scalar;
+    }
+}
+
+
+const char* WordTokenizer::nameOf(Implementation implementation) noexcept
+{
+    switch (implementation)
+    {
+    case Implementation::Scalar:
+        return "Scalar";
+
+    case Implementation::SSE2:
+        return "SSE2";
+
+    case Implementation::AVX2:
+        return "AVX2";
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,95 @@
+// WordTokenizer.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A WordTokenizer finds the words in a line of text, using the rules that
+// TextFileReader has always used: a word begins with a letter or digit and
+// continues through any letters, digits, hyphens, and apostrophes that
+// follow it, except that a hyphen or apostrophe at the end of a word is
+// trimmed off.  Everything else separates words.
+//
+// Letters and digits are the ASCII ones, which is what std::isalnum() means
+// in the "C" locale that the spell checker runs in; unlike std::isalnum(),
+// a WordTokenizer doesn't consult the locale one character at a time.
+//
+// There are three implementations, which find the same words:
+//
+//   * Scalar, which classifies one byte at a time
+//   * SSE2, which classifies 16 bytes at a time into a bitmask of letters
+//     and digits and a bitmask of characters that can continue a word, then
+//     finds the beginning and end of the word with a count of trailing zero
+//     bits in those masks
+//   * AVX2, which does the same 32 bytes at a time
+//
+// Which implementations are available is decided at run time, so the
+// program needn't be compiled specifically for AVX2.  A default-constructed
+// WordTokenizer uses whichever is best for ordinary text, which is SSE2
+// wherever it's available (see bestAvailable()); AVX2 only pays off when
+// words and the gaps between them are long.
+
+#ifndef WORDTOKENIZER_HPP
+#define WORDTOKENIZER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+
+
+class WordTokenizer
+{
+public:
+    enum class Implementation
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+public:
+    // Initializes a WordTokenizer to use the best available implementation.
+    WordTokenizer();
+
+    // Initializes a WordTokenizer to use the given implementation, which
+    // must be available.
+    explicit WordTokenizer(Implementation implementation);
+
+
+    // nextWord() finds the next word in the given text, starting at the
+    // given index.  If there is one, the position of its first character
+    // is stored into start and its length (after trimming) into length,
+    // index is moved past it, and true is returned; otherwise, index is
+    // moved to the end of the text and false is returned.
+    bool nextWord(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length) const
+    {
+        return nextWordFunction(text, index, start, length);
+    }
+
+
+    // implementation() returns the implementation this tokenizer uses.
+    Implementation implementation() const noexcept;
+
+
+    // isAvailable() returns true if the given implementation can be used
+    // on this processor, and bestAvailable() returns the one that's best
+    // for ordinary text among those that can be.
+    static bool isAvailable(Implementation implementation) noexcept;
+    static Implementation bestAvailable() noexcept;
+
+    // nameOf() returns a short name for an implementation, for output.
+    static const char* nameOf(Implementation implementation) noexcept;
+
+
+private:
+    using NextWordFunction =
+        bool (*)(std::string_view, std::size_t&, std::size_t&, std::size_t&);
+
+    Implementation implementation_;
+    NextWordFunction nextWordFunction;
+};
+
+
+
+#endif // WORDTOKENIZER_HPP
@@ -0,0 +1,126 @@
+// AddLatencyBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file, then adds every word in it, one at a
+// time, to an empty HashSet, timing each call to add() separately.  This
+// is done in both resize modes, a number of times over, and the median,
+// 99th percentile, 99.9th percentile, and slowest add() are reported in
+// each mode, along with the total time taken by all of them.  Resizing all
+// at once makes the few add() calls that trigger a resizing very slow;
+// resizing incrementally spreads that work across the add() calls after
+// them, so the slowest ones should be much faster, in exchange for the
+// typical one being slightly slower.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "CompiledWordSet.hpp"
+#include "HashSet.hpp"
+#include "StringHashing.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+    using Clock = std::chrono::steady_clock;
+    using ProductHashSet = HashSet<std::string, ProductHashPolicy>;
+
+
+    // percentile() returns the duration that the given fraction of the
+    // (sorted) durations are no longer than.
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        std::size_t index = static_cast<std::size_t>(fraction * (sorted.size() - 1));
+        return sorted[index];
+    }
+
+
+    void runMode(
+        std::ostream& out, const std::string& name, ProductHashSet::ResizeMode mode,
+        const std::vector<std::string>& words)
+    {
+        std::vector<double> durations;
+        durations.reserve(words.size() * REPETITIONS);
+
+        double total = 0.0;
+        unsigned int missing = 0;
+
+        for (unsigned int repetition = 0; repetition < REPETITIONS; ++repetition)
+        {
+            ProductHashSet set;
+            set.setResizeMode(mode);
+
+            for (const std::string& word : words)
+            {
+                Clock::time_point start = Clock::now();
+                set.add(word);
+                Clock::time_point stop = Clock::now();
+
+                double duration = std::chrono::duration<double, std::nano>(stop - start).count();
+                durations.push_back(duration);
+                total += duration;
+            }
+
+            for (const std::string& word : words)
+            {
+                missing += set.contains(word) ? 0 : 1;
+            }
+        }
+
+        std::sort(durations.begin(), durations.end());
+
+        out << std::left << std::setw(16) << name;
+        out << std::right << std::fixed << std::setprecision(0);
+        out << std::setw(10) << percentile(durations, 0.5) << "nsec";
+        out << std::setw(10) << percentile(durations, 0.99) << "nsec";
+        out << std::setw(10) << percentile(durations, 0.999) << "nsec";
+        out << std::setw(12) << durations.back() << "nsec";
+        out << std::setw(10) << total / REPETITIONS / 1000.0 << "usec";
+        out << std::setw(10) << missing;
+        out << std::endl;
+    }
+}
+
+
+
+void runAddLatencyBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::getline(in, wordFilePath);
+
+    CompiledWordSet allWords;
+    WordSetLoader{}.load(wordFilePath, allWords);
+
+    std::vector<std::string> words;
+
+    for (unsigned int i = 0; i < allWords.size(); ++i)
+    {
+        words.emplace_back(allWords.wordAt(i));
+    }
+
+    out << std::endl;
+    out << "Words added: " << words.size() << " (" << REPETITIONS << " times in each mode)" << std::endl;
+    out << "Lists moved per add() while resizing incrementally: "
+        << ProductHashSet::MIGRATION_STEP << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                       p50           p99         p99.9             max         Total   Missing" << std::endl;
+
+    if (words.empty())
+    {
+        out << "ERROR: The word file needs at least one word" << std::endl;
+        return;
+    }
+
+    runMode(out, "All at once", ProductHashSet::ResizeMode::AllAtOnce, words);
+    runMode(out, "Incremental", ProductHashSet::ResizeMode::Incremental, words);
+}
@@ -0,0 +1,73 @@
+// AllocationCounter.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include "AllocationCounter.hpp"
+
+
+
+namespace
+{
+    std::atomic<unsigned long long> allocations{0};
+}
+
+
+unsigned long long allocationCount() noexcept
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+
+std::size_t heapBytesInUse() noexcept
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
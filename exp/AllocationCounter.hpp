@@ -0,0 +1,29 @@
+// AllocationCounter.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The benchmarks replace the global operator new, so that they can count
+// how many dynamic allocations take place while the code they're measuring
+// runs.  allocationCount() returns the number of allocations made so far.
+//
+// heapBytesInUse() returns the number of bytes currently allocated from the
+// heap, whether by operator new or by std::malloc() and its relatives
+// (such as the std::calloc() that HashSet uses for its arrays).  It relies
+// on glibc's mallinfo2(), which only describes the main thread's part of
+// the heap (and memory that's mapped separately for large blocks), so
+// it's only meaningful for memory allocated on the main thread.
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+
+
+
+unsigned long long allocationCount() noexcept;
+std::size_t heapBytesInUse() noexcept;
+
+
+
+#endif // ALLOCATIONCOUNTER_HPP
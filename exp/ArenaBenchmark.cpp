@@ -0,0 +1,145 @@
+// ArenaBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file and a text file, then compares a HashSet
+// and an AVLSet whose nodes are allocated one at a time with new (their
+// default) against ones whose nodes are allocated by an
+// ArenaNodeAllocator.  For each, a number of times over, the set is loaded
+// with every word (with bulkLoad(), as WordSetLoader does), every word of
+// the text is looked up in it, and it's destroyed; the average time taken
+// by each step is reported.
+
+#include <cstddef>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AVLSet.hpp"
+#include "Benchmarks.hpp"
+#include "CompiledWordSet.hpp"
+#include "HashSet.hpp"
+#include "NodeAllocator.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 5;
+
+
+    struct Result
+    {
+        double loadDuration = 0.0;
+        double lookupDuration = 0.0;
+        double teardownDuration = 0.0;
+        std::size_t lookups = 0;
+        unsigned int found = 0;
+    };
+
+
+    template <typename SetType>
+    Result run(
+        const std::vector<std::string>& words, const std::vector<std::string>& text)
+    {
+        Result result;
+
+        for (unsigned int repetition = 0; repetition < REPETITIONS; ++repetition)
+        {
+            Stopwatch stopwatch;
+            stopwatch.start();
+
+            std::unique_ptr<SetType> set = std::make_unique<SetType>();
+            set->bulkLoad(words.data(), words.data() + words.size());
+
+            stopwatch.stop();
+            result.loadDuration += stopwatch.lastDuration() / REPETITIONS;
+
+            unsigned int found = 0;
+            stopwatch.start();
+
+            for (const std::string& word : text)
+            {
+                found += set->contains(std::string_view{word}) ? 1 : 0;
+            }
+
+            stopwatch.stop();
+            result.lookupDuration += stopwatch.lastDuration() / REPETITIONS;
+            result.found = found;
+
+            stopwatch.start();
+            set.reset();
+            stopwatch.stop();
+            result.teardownDuration += stopwatch.lastDuration() / REPETITIONS;
+        }
+
+        result.lookups = text.size();
+        return result;
+    }
+
+
+    void printRow(std::ostream& out, const std::string& name, const Result& result)
+    {
+        double lookups = result.lookups == 0 ? 1.0 : static_cast<double>(result.lookups);
+
+        out << std::left << std::setw(20) << name;
+        out << std::right << std::fixed << std::setprecision(0);
+        out << std::setw(12) << result.loadDuration << "usec";
+        out << std::setprecision(1) << std::setw(14) << result.lookupDuration * 1000.0 / lookups << "nsec";
+        out << std::setprecision(0) << std::setw(12) << result.teardownDuration << "usec";
+        out << std::setw(10) << result.found;
+        out << std::endl;
+    }
+
+
+    using HeapHashSet = HashSet<std::string, ProductHashPolicy>;
+    using ArenaHashSet = HashSet<std::string, ProductHashPolicy, ArenaNodeAllocator>;
+    using HeapAVLSet = AVLSet<std::string>;
+    using ArenaAVLSet = AVLSet<std::string, ArenaNodeAllocator>;
+}
+
+
+
+void runArenaBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+
+    CompiledWordSet allWords;
+    WordSetLoader{}.load(wordFilePath, allWords);
+
+    std::vector<std::string> words;
+
+    for (unsigned int i = 0; i < allWords.size(); ++i)
+    {
+        words.emplace_back(allWords.wordAt(i));
+    }
+
+    std::vector<std::string> text;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        text.push_back(reader.currentWord());
+    }
+
+    out << std::endl;
+    out << "Words loaded: " << words.size() << std::endl;
+    out << "Words looked up: " << text.size() << std::endl;
+    out << "Repetitions: " << REPETITIONS << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                          Load          Lookup          Teardown     Found" << std::endl;
+
+    printRow(out, "HashSet (new)", run<HeapHashSet>(words, text));
+    printRow(out, "HashSet (arena)", run<ArenaHashSet>(words, text));
+    printRow(out, "AVLSet (new)", run<HeapAVLSet>(words, text));
+    printRow(out, "AVLSet (arena)", run<ArenaAVLSet>(words, text));
+}
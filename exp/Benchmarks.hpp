@@ -0,0 +1,78 @@
+// Benchmarks.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Each of these functions runs one benchmark, reading whatever else it
+// needs (such as file paths) from the given input stream and writing a
+// table of results to the given output stream.
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <iostream>
+
+
+
+// Times each call to add() as every word in a word file is added to a
+// HashSet, resizing all at once and incrementally, reporting the median,
+// tail, and slowest times in each mode.
+void runAddLatencyBenchmark(std::istream& in, std::ostream& out);
+
+
+// Compares the time taken to load, look up words in, and destroy a
+// HashSet and an AVLSet with their nodes allocated one at a time against
+// ones with their nodes allocated by an ArenaNodeAllocator.
+void runArenaBenchmark(std::istream& in, std::ostream& out);
+
+
+// Compares generating edit candidates by copying and editing a std::string
+// per candidate against EditCandidateGenerator, counting allocations and
+// time per misspelled word.
+void runCandidateBenchmark(std::istream& in, std::ostream& out);
+
+
+// Measures the lookups per second that several threads make against a
+// ConcurrentHashSet, with and without another thread adding words to it,
+// and against a HashSet behind a mutex, checking that no word already in
+// the set is ever missed.
+void runConcurrentBenchmark(std::istream& in, std::ostream& out);
+
+
+// Compares finding the words within one edit of each misspelled word by
+// trying every edit against a HashSet with walking a TrieSet with a
+// LevenshteinAutomaton, then times the TrieSet at distances 2 and 3.
+void runDistanceBenchmark(std::istream& in, std::ostream& out);
+
+
+// Builds a FrozenHashSet from word lists of several sizes, from one word
+// up to a whole word file, timing each build and checking that each set
+// finds exactly the words it was built from.
+void runFrozenBuildBenchmark(std::istream& in, std::ostream& out);
+
+
+// Counts the element comparisons that a HashSet makes for the lookups a
+// spell checker would make, with and without comparing cached hashes
+// first, for each string hash function.
+void runHashCacheBenchmark(std::istream& in, std::ostream& out);
+
+
+// Reports the heap memory that each kind of Set occupies, in total and
+// per word, once the words in a word file have been loaded into it.
+void runMemoryBenchmark(std::istream& in, std::ostream& out);
+
+
+// Times each string hash function on the strings a spell checker would
+// hash, one at a time and (for the 64-bit wyhash) in batches, and counts
+// the distinct buckets their hashes fall into.
+void runHashRateBenchmark(std::istream& in, std::ostream& out);
+
+
+// Compares finding the words in a text file with the original
+// byte-at-a-time std::isalnum() loop against each WordTokenizer
+// implementation, in tokens and bytes per second.
+void runTokenizerBenchmark(std::istream& in, std::ostream& out);
+
+
+
+#endif // BENCHMARKS_HPP
@@ -0,0 +1,209 @@
+// CandidateBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file and a text file, finds the misspelled
+// words in the text, and then generates every edit candidate for them in
+// two ways: by copying and editing a std::string for each candidate (the
+// way WordChecker originally did), and with EditCandidateGenerator.  Each
+// candidate is looked up in a HashSet either way.  The allocations and
+// time spent per misspelled word are reported for each, along with the
+// cost of WordChecker::findSuggestions() as a whole.
+
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AllocationCounter.hpp"
+#include "Benchmarks.hpp"
+#include "EditCandidateGenerator.hpp"
+#include "HashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordChecker.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+
+    template <typename VisitFunction>
+    void generateByCopying(const std::string& word, VisitFunction&& visit)
+    {
+        for (int i = 0; i + 1 < static_cast<int>(word.size()); ++i)
+        {
+            std::string temp = word;
+            std::swap(temp[i], temp[i + 1]);
+            visit(EditKind::Swap, temp);
+        }
+
+        for (int i = 0; i < static_cast<int>(word.size()) + 1; ++i)
+        {
+            for (int j = 0; j < static_cast<int>(alphabet.size()); ++j)
+            {
+                std::string temp = word;
+                temp.insert(i, alphabet.substr(j, 1));
+                visit(EditKind::Insert, temp);
+            }
+        }
+
+        for (int i = 0; i < static_cast<int>(word.size()); ++i)
+        {
+            std::string temp = word;
+            temp.erase(i, 1);
+            visit(EditKind::Delete, temp);
+        }
+
+        for (int i = 0; i < static_cast<int>(word.size()); ++i)
+        {
+            std::string temp = word;
+
+            for (int j = 0; j < static_cast<int>(alphabet.size()); ++j)
+            {
+                temp.replace(i, 1, alphabet.substr(j, 1));
+                visit(EditKind::Replace, temp);
+            }
+        }
+
+        for (int i = 1; i < static_cast<int>(word.size()); ++i)
+        {
+            std::string left = word.substr(0, i);
+            std::string right = word.substr(i);
+            visit(EditKind::Split, left + " " + right);
+        }
+    }
+
+
+    struct Measurement
+    {
+        unsigned long long candidates = 0;
+        unsigned long long hits = 0;
+        unsigned long long allocations = 0;
+        double duration = 0.0;
+    };
+
+
+    // measure() calls the given function for each misspelled word, counting
+    // the allocations and time taken altogether.  The function is passed a
+    // Measurement so it can count candidates and hits.
+    template <typename WordFunction>
+    Measurement measure(const std::vector<std::string>& misspellings, WordFunction forEachWord)
+    {
+        Measurement m;
+        Stopwatch stopwatch;
+
+        unsigned long long allocationsBefore = allocationCount();
+        stopwatch.start();
+
+        for (const std::string& word : misspellings)
+        {
+            forEachWord(word, m);
+        }
+
+        stopwatch.stop();
+        m.allocations = allocationCount() - allocationsBefore;
+        m.duration = stopwatch.lastDuration();
+
+        return m;
+    }
+
+
+    // probe() returns a visit function that looks up each non-split
+    // candidate in the given set, counting candidates and hits.
+    auto probe(const Set<std::string>& words, Measurement& m)
+    {
+        return
+            [&words, &m](EditKind kind, std::string_view candidate)
+            {
+                ++m.candidates;
+
+                if (kind != EditKind::Split && words.contains(candidate))
+                {
+                    ++m.hits;
+                }
+            };
+    }
+
+
+    void printRow(std::ostream& out, const std::string& name, const Measurement& m, std::size_t words)
+    {
+        out << std::left << std::setw(22) << name;
+        out << std::right << std::setw(12) << m.candidates;
+        out << std::right << std::setw(14) << m.allocations;
+        out << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+            << (words > 0 ? static_cast<double>(m.allocations) / words : 0.0);
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+            << m.duration << "usec";
+        out << std::endl;
+    }
+}
+
+
+
+void runCandidateBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+
+    HashSet<std::string> words{hashStringAsProduct, hashStringAsProduct};
+    WordSetLoader{}.load(wordFilePath, words);
+
+    std::vector<std::string> misspellings;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        std::string word = reader.currentWord();
+
+        if (!words.contains(word))
+        {
+            misspellings.push_back(word);
+        }
+    }
+
+    Measurement copying = measure(
+        misspellings,
+        [&](const std::string& word, Measurement& m)
+        {
+            generateByCopying(word, probe(words, m));
+        });
+
+    EditCandidateGenerator generator;
+
+    Measurement inPlace = measure(
+        misspellings,
+        [&](const std::string& word, Measurement& m)
+        {
+            generator.generate(word, probe(words, m));
+        });
+
+    WordChecker wordChecker{words};
+    unsigned long long duplicatesSuppressed = 0;
+
+    Measurement suggestions = measure(
+        misspellings,
+        [&](const std::string& word, Measurement& m)
+        {
+            m.hits += wordChecker.findSuggestions(word).size();
+            duplicatesSuppressed += wordChecker.lastSuggestionStats().duplicatesSuppressed;
+        });
+
+    out << std::endl;
+    out << "Misspelled words: " << misspellings.size() << std::endl;
+    out << "Candidate hits:   " << inPlace.hits << " (copying: " << copying.hits << ")" << std::endl;
+    out << "Suggestions:      " << suggestions.hits << std::endl;
+    out << "Duplicates:       " << duplicatesSuppressed << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                        Candidates   Allocations   Allocs/Word        Time" << std::endl;
+
+    printRow(out, "Copying", copying, misspellings.size());
+    printRow(out, "EditCandidateGenerator", inPlace, misspellings.size());
+    printRow(out, "findSuggestions()", suggestions, misspellings.size());
+}
@@ -0,0 +1,267 @@
+// ConcurrentBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file, the path to a text file, and a number of
+// reader threads (or a blank line, for one per hardware thread).  Half of
+// the words (every other one) are loaded into a set, then each reader
+// looks up every word of the text, several times over, along with one of
+// the loaded words after each, which must always be found.  This is done
+// three ways:
+//
+//   * with a ConcurrentHashSet that nothing is added to
+//   * with a ConcurrentHashSet to which another thread adds the other half
+//     of the words while the readers run, replacing its table as it grows
+//   * with a HashSet behind a std::mutex, which every lookup and addition
+//     has to lock, to which the other half of the words are added likewise
+//
+// For each, the lookups per second (across all of the readers) and the
+// time taken by the additions are reported, along with the number of
+// loaded words that weren't found (which should be zero) and the number of
+// words missing afterward (also zero).
+
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "CompiledWordSet.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "HashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "ThreadPool.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int PASSES = 5;
+
+
+    // A LockedHashSet is the alternative to a ConcurrentHashSet: a HashSet
+    // that's only ever used with its mutex locked.
+    class LockedHashSet
+    {
+    public:
+        LockedHashSet()
+            : set{}
+        {
+        }
+
+        void add(const std::string& word)
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            set.add(word);
+        }
+
+        bool contains(std::string_view word) const
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            return set.contains(word);
+        }
+
+    private:
+        HashSet<std::string, ProductHashPolicy> set;
+        mutable std::mutex mutex;
+    };
+
+
+    struct Result
+    {
+        double lookupsPerSecond;
+        double addDuration;
+        unsigned long long loadedMissing;
+        unsigned int missingAfterward;
+    };
+
+
+    // run() expects the loaded words to be in the set already.
+    template <typename SetType>
+    Result run(
+        SetType& set, unsigned int readerCount, bool adding,
+        const std::vector<std::string>& loaded, const std::vector<std::string>& added,
+        const std::vector<std::string>& text)
+    {
+        std::atomic<unsigned long long> loadedMissing{0};
+        std::atomic<unsigned long long> lookups{0};
+        std::atomic<unsigned long long> hits{0};
+        double addDuration = 0.0;
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        {
+            std::vector<std::thread> threads;
+
+            for (unsigned int reader = 0; reader < readerCount; ++reader)
+            {
+                threads.emplace_back(
+                    [&, reader]
+                    {
+                        unsigned long long found = 0;
+                        unsigned long long missing = 0;
+                        std::size_t next = reader;
+
+                        for (unsigned int pass = 0; pass < PASSES; ++pass)
+                        {
+                            for (const std::string& word : text)
+                            {
+                                found += set.contains(std::string_view{word}) ? 1 : 0;
+
+                                if (!set.contains(std::string_view{loaded[next]}))
+                                {
+                                    ++missing;
+                                }
+
+                                next = next + 1 < loaded.size() ? next + 1 : 0;
+                            }
+                        }
+
+                        lookups += 2ull * PASSES * text.size();
+                        hits += found;
+                        loadedMissing += missing;
+                    });
+            }
+
+            if (adding)
+            {
+                Stopwatch addStopwatch;
+                addStopwatch.start();
+
+                for (const std::string& word : added)
+                {
+                    set.add(word);
+                }
+
+                addStopwatch.stop();
+                addDuration = addStopwatch.lastDuration();
+            }
+
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        stopwatch.stop();
+
+        unsigned int missingAfterward = 0;
+
+        for (const std::string& word : adding ? added : loaded)
+        {
+            missingAfterward += set.contains(std::string_view{word}) ? 0 : 1;
+        }
+
+        double seconds = stopwatch.lastDuration() / 1000000.0;
+
+        return Result{
+            seconds > 0.0 ? lookups.load() / seconds : 0.0,
+            addDuration, loadedMissing.load(), missingAfterward};
+    }
+
+
+    template <typename SetType>
+    void addAll(SetType& set, const std::vector<std::string>& words)
+    {
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+    }
+
+
+    void printRow(std::ostream& out, const std::string& name, const Result& result)
+    {
+        out << std::left << std::setw(24) << name;
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(14) << result.lookupsPerSecond;
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(12) << result.addDuration << "usec";
+        out << std::right << std::setw(15) << result.loadedMissing;
+        out << std::right << std::setw(10) << result.missingAfterward;
+        out << std::endl;
+    }
+}
+
+
+
+void runConcurrentBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::string readerLine;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+    std::getline(in, readerLine);
+
+    unsigned int readerCount = ThreadPool::defaultThreadCount();
+
+    if (!readerLine.empty() && std::stoi(readerLine) > 0)
+    {
+        readerCount = static_cast<unsigned int>(std::stoi(readerLine));
+    }
+
+    CompiledWordSet allWords;
+    WordSetLoader{}.load(wordFilePath, allWords);
+
+    std::vector<std::string> loaded;
+    std::vector<std::string> added;
+
+    for (unsigned int i = 0; i < allWords.size(); ++i)
+    {
+        (i % 2 == 0 ? loaded : added).emplace_back(allWords.wordAt(i));
+    }
+
+    std::vector<std::string> text;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        text.push_back(reader.currentWord());
+    }
+
+    out << std::endl;
+    out << "Readers: " << readerCount << std::endl;
+    out << "Words loaded first: " << loaded.size() << std::endl;
+    out << "Words added while reading: " << added.size() << std::endl;
+    out << "Lookups per reader: " << 2ull * PASSES * text.size() << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                          Lookups/sec    AddTime       LoadedMissing   Missing" << std::endl;
+
+    if (loaded.empty())
+    {
+        out << "ERROR: The word file needs at least one word" << std::endl;
+        return;
+    }
+
+    {
+        ConcurrentHashSet<std::string> set{hashStringAsProduct, hashStringAsProduct};
+        addAll(set, loaded);
+        printRow(out, "Concurrent (no adds)", run(set, readerCount, false, loaded, added, text));
+    }
+
+    unsigned int tablesRetired = 0;
+
+    {
+        ConcurrentHashSet<std::string> set{hashStringAsProduct, hashStringAsProduct};
+        addAll(set, loaded);
+
+        unsigned int retiredBefore = set.tablesRetired();
+        printRow(out, "Concurrent (adding)", run(set, readerCount, true, loaded, added, text));
+        tablesRetired = set.tablesRetired() - retiredBefore;
+    }
+
+    {
+        LockedHashSet set;
+        addAll(set, loaded);
+        printRow(out, "Locked HashSet (adding)", run(set, readerCount, true, loaded, added, text));
+    }
+
+    out << std::endl;
+    out << "Tables replaced while adding: " << tablesRetired << std::endl;
+}
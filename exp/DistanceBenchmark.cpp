@@ -0,0 +1,139 @@
+// DistanceBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file and a text file, and finds the misspelled
+// words in the text.  For each misspelled word, the words within one edit
+// are found in two ways: by generating every edit with an
+// EditCandidateGenerator and looking each one up in a HashSet (the way
+// WordChecker does it), and by walking a TrieSet with a LevenshteinAutomaton.
+// The TrieSet is then asked for the words within two and three edits, which
+// would be impractical by brute force.
+//
+// The two approaches don't find quite the same words at distance 1: the
+// generator only inserts and replaces letters of the alphabet, while the
+// automaton allows any character (such as an apostrophe or hyphen).
+
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "EditCandidateGenerator.hpp"
+#include "HashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "SuggestionDeduplicator.hpp"
+#include "TextFileReader.hpp"
+#include "TrieSet.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    void printRow(
+        std::ostream& out, const std::string& name, unsigned int distance,
+        unsigned long long matches, double duration, std::size_t words)
+    {
+        out << std::left << std::setw(20) << name;
+        out << std::right << std::setw(8) << distance;
+        out << std::right << std::setw(12) << matches;
+        out << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+            << (words > 0 ? static_cast<double>(matches) / words : 0.0);
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+            << duration << "usec";
+        out << std::right << std::fixed << std::setprecision(2) << std::setw(12)
+            << (words > 0 ? duration / words : 0.0) << "usec";
+        out << std::endl;
+    }
+}
+
+
+
+void runDistanceBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+
+    HashSet<std::string> hashSet{hashStringAsProduct, hashStringAsProduct};
+    WordSetLoader{}.load(wordFilePath, hashSet);
+
+    TrieSet trieSet;
+    WordSetLoader{}.load(wordFilePath, trieSet);
+
+    std::vector<std::string> misspellings;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        std::string word = reader.currentWord();
+
+        if (!hashSet.contains(word))
+        {
+            misspellings.push_back(word);
+        }
+    }
+
+    out << std::endl;
+    out << "Misspelled words: " << misspellings.size() << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                    Distance     Matches  Matches/Word        Time    Time/Word" << std::endl;
+
+    Stopwatch stopwatch;
+
+    {
+        EditCandidateGenerator generator;
+        SuggestionDeduplicator deduplicator;
+        std::vector<std::string> found;
+        unsigned long long matches = 0;
+
+        stopwatch.start();
+
+        for (const std::string& word : misspellings)
+        {
+            found.clear();
+            deduplicator.reset();
+
+            generator.generate(
+                word,
+                [&](EditKind kind, std::string_view candidate)
+                {
+                    if (kind != EditKind::Split && hashSet.contains(candidate))
+                    {
+                        deduplicator.addIfNew(candidate, found);
+                    }
+                });
+
+            matches += found.size();
+        }
+
+        stopwatch.stop();
+
+        printRow(out, "Brute force + Hash", 1, matches, stopwatch.lastDuration(), misspellings.size());
+    }
+
+    for (unsigned int distance = 1; distance <= LevenshteinAutomaton::MAX_DISTANCE; ++distance)
+    {
+        unsigned long long matches = 0;
+
+        stopwatch.start();
+
+        for (const std::string& word : misspellings)
+        {
+            trieSet.findWithinDistance(
+                word, distance,
+                [&](std::string_view /* match */, unsigned int)
+                {
+                    ++matches;
+                });
+        }
+
+        stopwatch.stop();
+
+        printRow(out, "Trie + automaton", distance, matches, stopwatch.lastDuration(), misspellings.size());
+    }
+}
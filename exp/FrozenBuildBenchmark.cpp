@@ -0,0 +1,118 @@
+// FrozenBuildBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file, then builds a FrozenHashSet from the
+// first n words in it, for a range of sizes n from a single word up to
+// all of them, reporting how long each build took and how many seeds it
+// tried.  Small sets are included on purpose, since a perfect hash has
+// the fewest free slots to choose from when there are only a few words.
+// Each set is then checked: every one of its n words must be found, and
+// none of the words that were left out of it may be.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "CompiledWordSet.hpp"
+#include "FrozenHashSet.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+
+    // The number of words left out of each set that are looked up in it,
+    // to check that they aren't found.
+    constexpr unsigned int ABSENT_LOOKUPS = 1000;
+
+
+    void runSize(std::ostream& out, const std::vector<std::string>& words, unsigned int n)
+    {
+        Clock::time_point start = Clock::now();
+
+        FrozenHashSet set;
+        set.bulkLoad(words.data(), words.data() + n);
+
+        Clock::time_point stop = Clock::now();
+
+        unsigned int missing = 0;
+
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            missing += set.contains(words[i]) ? 0 : 1;
+        }
+
+        unsigned int unexpected = 0;
+        unsigned int absentEnd = std::min<unsigned int>(words.size(), n + ABSENT_LOOKUPS);
+
+        for (unsigned int i = n; i < absentEnd; ++i)
+        {
+            unexpected += set.contains(words[i]) ? 1 : 0;
+        }
+
+        out << std::right << std::setw(10) << n;
+        out << std::fixed << std::setprecision(0);
+        out << std::setw(12) << std::chrono::duration<double, std::micro>(stop - start).count() << "usec";
+        out << std::setw(10) << set.buildAttempts();
+        out << std::setw(10) << set.size();
+        out << std::setw(10) << missing;
+        out << std::setw(12) << unexpected;
+        out << std::endl;
+    }
+}
+
+
+
+void runFrozenBuildBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::getline(in, wordFilePath);
+
+    CompiledWordSet allWords;
+    WordSetLoader{}.load(wordFilePath, allWords);
+
+    std::vector<std::string> words;
+
+    for (unsigned int i = 0; i < allWords.size(); ++i)
+    {
+        words.emplace_back(allWords.wordAt(i));
+    }
+
+    // The words in a CompiledWordSet are sorted, so they're shuffled (the
+    // same way every time) before any are chosen, so that the smaller sets
+    // aren't all made up of words that begin with the same letters.
+    std::uint64_t state = 0x2545f4914f6cdd1dull;
+
+    for (std::size_t i = words.size(); i > 1; --i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        std::swap(words[i - 1], words[(state >> 33) % i]);
+    }
+
+    out << std::endl;
+    out << "Words: " << words.size() << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "     Words          Build  Attempts      Size   Missing  Unexpected" << std::endl;
+
+    const unsigned int sizes[] = {1, 2, 3, 10, 100, 200, 999, 1000, 3000, 10000, 100000};
+
+    for (unsigned int n : sizes)
+    {
+        if (n < words.size())
+        {
+            runSize(out, words, n);
+        }
+    }
+
+    runSize(out, words, static_cast<unsigned int>(words.size()));
+}
@@ -0,0 +1,123 @@
+// HashCacheBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file and a text file, and gathers the lookups a
+// spell checker would make: every word in the text, plus every edit
+// candidate (other than splits) of the misspelled ones.  For each string
+// hash function, the words are loaded into a HashSet, and the lookups are
+// made against it.  HashSet::nodesSearched() gives the number of element
+// comparisons the lookups would make without cached hashes (one per node
+// visited), while HashSet::elementComparisons() gives the number they
+// make with them (one per node whose hash matches).
+//
+// The zero hash is left out: with every word in one list, each lookup
+// would visit all of them, and the cached hashes (all zero) can't help.
+
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "EditCandidateGenerator.hpp"
+#include "HashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    void runHashFunction(
+        std::ostream& out, const std::string& name,
+        unsigned int (*hashFunction)(std::string_view),
+        const std::string& wordFilePath, const std::vector<std::string>& lookups)
+    {
+        HashSet<std::string> wordSet{
+            [hashFunction](const std::string& s) { return hashFunction(s); },
+            hashFunction};
+
+        WordSetLoader{}.load(wordFilePath, wordSet);
+
+        unsigned long long hits = 0;
+        unsigned long long nodes = 0;
+        unsigned long long comparisons = 0;
+
+        for (const std::string& lookup : lookups)
+        {
+            nodes += wordSet.nodesSearched(lookup);
+            comparisons += wordSet.elementComparisons(lookup);
+        }
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (const std::string& lookup : lookups)
+        {
+            hits += wordSet.contains(lookup) ? 1 : 0;
+        }
+
+        stopwatch.stop();
+
+        double count = lookups.empty() ? 1.0 : static_cast<double>(lookups.size());
+
+        out << std::left << std::setw(10) << name;
+        out << std::right << std::setw(10) << hits;
+        out << std::right << std::setw(14) << nodes;
+        out << std::right << std::setw(14) << comparisons;
+        out << std::right << std::fixed << std::setprecision(3) << std::setw(10) << nodes / count;
+        out << std::right << std::fixed << std::setprecision(3) << std::setw(10) << comparisons / count;
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(10)
+            << stopwatch.lastDuration() << "usec";
+        out << std::endl;
+    }
+}
+
+
+
+void runHashCacheBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+
+    HashSet<std::string> wordSet{hashStringAsProduct, hashStringAsProduct};
+    WordSetLoader{}.load(wordFilePath, wordSet);
+
+    EditCandidateGenerator generator;
+    std::vector<std::string> lookups;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        std::string word = reader.currentWord();
+        lookups.push_back(word);
+
+        if (!wordSet.contains(word))
+        {
+            generator.generate(
+                word,
+                [&lookups](EditKind kind, std::string_view candidate)
+                {
+                    if (kind != EditKind::Split)
+                    {
+                        lookups.emplace_back(candidate);
+                    }
+                });
+        }
+    }
+
+    out << std::endl;
+    out << "Lookups: " << lookups.size() << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                          Element comparisons     Per lookup" << std::endl;
+    out << "Hash            Hits      Uncached        Cached  Uncached    Cached      Time" << std::endl;
+
+    runHashFunction(out, "SUM", hashStringAsSum, wordFilePath, lookups);
+    runHashFunction(out, "PRODUCT", hashStringAsProduct, wordFilePath, lookups);
+    runHashFunction(out, "WY", hashStringAsWy, wordFilePath, lookups);
+}
@@ -0,0 +1,174 @@
+// HashRateBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file and a text file, and gathers the strings
+// a spell checker would hash: every word in the text, plus every edit
+// candidate (other than splits) of the misspelled ones.  Each string hash
+// function then hashes all of them, a number of times over, and the time
+// per hash is reported, along with how many distinct values the hashes
+// take when reduced to the bits a table of 2^20 buckets would use.
+// hashStringsAsWy64() is measured separately, hashing the strings in the
+// same order but in batches of one misspelled word's candidates.
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Benchmarks.hpp"
+#include "EditCandidateGenerator.hpp"
+#include "HashSet.hpp"
+#include "Stopwatch.hpp"
+#include "StringHashing.hpp"
+#include "TextFileReader.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int REPETITIONS = 20;
+    constexpr unsigned int BUCKET_BITS = 20;
+
+
+    unsigned int distinctBuckets(const std::vector<std::uint64_t>& hashes)
+    {
+        std::vector<bool> seen(std::size_t{1} << BUCKET_BITS);
+        unsigned int distinct = 0;
+
+        for (std::uint64_t hash : hashes)
+        {
+            std::size_t bucket = static_cast<std::size_t>(hash) & (seen.size() - 1);
+
+            if (!seen[bucket])
+            {
+                seen[bucket] = true;
+                ++distinct;
+            }
+        }
+
+        return distinct;
+    }
+
+
+    void printRow(
+        std::ostream& out, const std::string& name, double duration,
+        const std::vector<std::uint64_t>& hashes)
+    {
+        double count = hashes.empty() ? 1.0 : static_cast<double>(hashes.size()) * REPETITIONS;
+
+        out << std::left << std::setw(16) << name;
+        out << std::right << std::fixed << std::setprecision(2) << std::setw(12)
+            << duration * 1000.0 / count << "nsec";
+        out << std::right << std::setw(12) << distinctBuckets(hashes);
+        out << std::endl;
+    }
+
+
+    template <typename HashFunction>
+    void runHashFunction(
+        std::ostream& out, const std::string& name, HashFunction hashFunction,
+        const std::vector<std::string_view>& strings)
+    {
+        std::vector<std::uint64_t> hashes(strings.size());
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (unsigned int repetition = 0; repetition < REPETITIONS; ++repetition)
+        {
+            for (std::size_t i = 0; i < strings.size(); ++i)
+            {
+                hashes[i] = hashFunction(strings[i]);
+            }
+        }
+
+        stopwatch.stop();
+
+        printRow(out, name, stopwatch.lastDuration(), hashes);
+    }
+
+
+    void runBatches(
+        std::ostream& out, const std::vector<std::string_view>& strings,
+        const std::vector<std::size_t>& batchStarts)
+    {
+        std::vector<std::uint64_t> hashes(strings.size());
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (unsigned int repetition = 0; repetition < REPETITIONS; ++repetition)
+        {
+            for (std::size_t batch = 0; batch + 1 < batchStarts.size(); ++batch)
+            {
+                std::size_t start = batchStarts[batch];
+
+                hashStringsAsWy64(
+                    strings.data() + start, batchStarts[batch + 1] - start,
+                    hashes.data() + start);
+            }
+        }
+
+        stopwatch.stop();
+
+        printRow(out, "WY64 (batch)", stopwatch.lastDuration(), hashes);
+    }
+}
+
+
+
+void runHashRateBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::string textFilePath;
+    std::getline(in, wordFilePath);
+    std::getline(in, textFilePath);
+
+    HashSet<std::string, ProductHashPolicy> wordSet;
+    WordSetLoader{}.load(wordFilePath, wordSet);
+
+    // Each word, and each misspelled word's candidates, make up a batch.
+    EditCandidateGenerator generator;
+    std::vector<std::string> lookups;
+    std::vector<std::size_t> batchStarts;
+
+    for (TextFileReader reader{textFilePath}; !reader.noMoreWords(); reader.advanceToNextWord())
+    {
+        std::string word = reader.currentWord();
+        batchStarts.push_back(lookups.size());
+        lookups.push_back(word);
+
+        if (!wordSet.contains(word))
+        {
+            batchStarts.push_back(lookups.size());
+
+            generator.generate(
+                word,
+                [&lookups](EditKind kind, std::string_view candidate)
+                {
+                    if (kind != EditKind::Split)
+                    {
+                        lookups.emplace_back(candidate);
+                    }
+                });
+        }
+    }
+
+    batchStarts.push_back(lookups.size());
+    batchStarts.erase(std::unique(batchStarts.begin(), batchStarts.end()), batchStarts.end());
+
+    std::vector<std::string_view> strings{lookups.begin(), lookups.end()};
+
+    out << std::endl;
+    out << "Strings: " << strings.size() << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "Hash                Time/Hash     Buckets" << std::endl;
+
+    runHashFunction(out, "PRODUCT", hashStringAsProduct, strings);
+    runHashFunction(out, "FNV1A64", hashStringAsFnv1a64, strings);
+    runHashFunction(out, "WY64", [](std::string_view s) { return hashStringAsWy64(s); }, strings);
+    runBatches(out, strings, batchStarts);
+}
@@ -0,0 +1,129 @@
+// MemoryBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a word file, then loads its words into each kind of
+// Set that the shell can use, reporting how much heap memory each one
+// occupies afterward, in total and per word.  (LIST, SKIPLIST, and EMPTY
+// are left out: a ListSet takes quadratic time to load, and the others
+// don't store the words.)  The words are read before any of the sets are
+// loaded and handed to each with bulkLoad(), all on the main thread, so
+// that heapBytesInUse() sees every allocation the set makes.
+
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AllocationCounter.hpp"
+#include "AVLSet.hpp"
+#include "Benchmarks.hpp"
+#include "BTreeSet.hpp"
+#include "CompiledWordSet.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "EytzingerSet.hpp"
+#include "FlatHashSet.hpp"
+#include "FrozenHashSet.hpp"
+#include "HashSet.hpp"
+#include "NodeAllocator.hpp"
+#include "Set.hpp"
+#include "StringHashing.hpp"
+#include "TrieSet.hpp"
+#include "WordSetLoader.hpp"
+
+
+
+namespace
+{
+    using SetFactory = std::function<std::unique_ptr<Set<std::string>>()>;
+
+
+    void measure(
+        std::ostream& out, const std::string& name, const SetFactory& makeSet,
+        const std::vector<std::string>& words)
+    {
+        std::size_t before = heapBytesInUse();
+
+        std::unique_ptr<Set<std::string>> set = makeSet();
+        set->reserve(static_cast<unsigned int>(words.size()));
+        set->bulkLoad(words.data(), words.data() + words.size());
+
+        std::size_t after = heapBytesInUse();
+        double bytes = after > before ? static_cast<double>(after - before) : 0.0;
+
+        out << std::left << std::setw(28) << name;
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(14) << bytes;
+        out << std::right << std::fixed << std::setprecision(1) << std::setw(14)
+            << (set->size() == 0 ? 0.0 : bytes / set->size());
+        out << std::endl;
+    }
+}
+
+
+
+void runMemoryBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string wordFilePath;
+    std::getline(in, wordFilePath);
+
+    std::vector<std::string> words;
+
+    {
+        CompiledWordSet allWords;
+        WordSetLoader{}.load(wordFilePath, allWords);
+
+        for (unsigned int i = 0; i < allWords.size(); ++i)
+        {
+            words.emplace_back(allWords.wordAt(i));
+        }
+    }
+
+    std::size_t characters = 0;
+
+    for (const std::string& word : words)
+    {
+        characters += word.size();
+    }
+
+    out << std::endl;
+    out << "Words: " << words.size() << std::endl;
+    out << "Average length: " << std::fixed << std::setprecision(2)
+        << (words.empty() ? 0.0 : static_cast<double>(characters) / words.size()) << std::endl;
+    out << "Node key: " << sizeof(NodeKey<std::string>) << " bytes, up to "
+        << NodeKey<std::string>::INLINE_CAPACITY << " characters inline" << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                                    Bytes     Bytes/word" << std::endl;
+
+    measure(
+        out, "AVL", [] { return std::make_unique<AVLSet<std::string>>(); }, words);
+    measure(
+        out, "AVL (arena)",
+        [] { return std::make_unique<AVLSet<std::string, ArenaNodeAllocator>>(); }, words);
+    measure(
+        out, "BTREE", [] { return std::make_unique<BTreeSet>(); }, words);
+    measure(
+        out, "COMPILED", [] { return std::make_unique<CompiledWordSet>(); }, words);
+    measure(
+        out, "CONCURRENT HASH PRODUCT",
+        [] { return std::make_unique<ConcurrentHashSet<std::string>>(hashStringAsProduct, hashStringAsProduct); },
+        words);
+    measure(
+        out, "EYTZINGER", [] { return std::make_unique<EytzingerSet<std::string>>(); }, words);
+    measure(
+        out, "FLAT HASH PRODUCT",
+        [] { return std::make_unique<FlatHashSet<std::string>>(hashStringAsProduct, hashStringAsProduct); },
+        words);
+    measure(
+        out, "FROZEN", [] { return std::make_unique<FrozenHashSet>(); }, words);
+    measure(
+        out, "HASH PRODUCT",
+        [] { return std::make_unique<HashSet<std::string, ProductHashPolicy>>(); }, words);
+    measure(
+        out, "HASH PRODUCT (arena)",
+        [] { return std::make_unique<HashSet<std::string, ProductHashPolicy, ArenaNodeAllocator>>(); },
+        words);
+    measure(
+        out, "TRIE", [] { return std::make_unique<TrieSet>(); }, words);
+}
@@ -0,0 +1,172 @@
+// TokenizerBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Reads the path to a text file, reads the whole file into memory, and
+// finds all of the words in it several times over: once with the
+// byte-at-a-time std::isalnum() loop that TextFileReader used originally,
+// and once with each WordTokenizer implementation that this processor
+// supports.  Since newlines separate words, the file is tokenized as one
+// piece of text rather than line by line.  Every approach should find the
+// same words; a checksum of their positions and lengths confirms it.
+
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "Benchmarks.hpp"
+#include "Stopwatch.hpp"
+#include "WordTokenizer.hpp"
+
+
+
+namespace
+{
+    constexpr unsigned int PASSES = 20;
+
+
+    // nextWordWithIsAlnum() is the loop from the original
+    // TextFileReader::advanceToNextWord(), minus the copying.
+    bool nextWordWithIsAlnum(
+        std::string_view text, std::size_t& index,
+        std::size_t& start, std::size_t& length)
+    {
+        while (index < text.size() && !std::isalnum(text[index]))
+        {
+            ++index;
+        }
+
+        if (index >= text.size())
+        {
+            return false;
+        }
+
+        start = index;
+
+        while (index < text.size() &&
+            (std::isalnum(text[index]) || text[index] == '-' || text[index] == '\''))
+        {
+            ++index;
+        }
+
+        length = index - start;
+
+        if (!std::isalnum(text[index - 1]))
+        {
+            --length;
+        }
+
+        return true;
+    }
+
+
+    struct Result
+    {
+        unsigned long long tokens;
+        std::uint64_t checksum;
+    };
+
+
+    template <typename NextWordFunction>
+    Result tokenize(std::string_view text, NextWordFunction nextWord)
+    {
+        Result result{0, 0};
+
+        for (unsigned int pass = 0; pass < PASSES; ++pass)
+        {
+            std::size_t index = 0;
+            std::size_t start;
+            std::size_t length;
+
+            while (nextWord(text, index, start, length))
+            {
+                ++result.tokens;
+                result.checksum = result.checksum * 31 + start * 7 + length;
+            }
+        }
+
+        return result;
+    }
+
+
+    void printRow(
+        std::ostream& out, const std::string& name, const Result& result,
+        const Result& expected, double duration, std::size_t bytes)
+    {
+        double seconds = duration / 1000000.0;
+
+        out << std::left << std::setw(16) << name;
+        out << std::right << std::setw(12) << result.tokens;
+        out << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+            << duration << "usec";
+        out << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+            << (seconds > 0.0 ? result.tokens / seconds / 1000000.0 : 0.0) << "M";
+        out << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+            << (seconds > 0.0 ? bytes * static_cast<double>(PASSES) / seconds / 1000000.0 : 0.0) << "MB";
+
+        if (result.tokens != expected.tokens || result.checksum != expected.checksum)
+        {
+            out << "   MISMATCH";
+        }
+
+        out << std::endl;
+    }
+}
+
+
+
+void runTokenizerBenchmark(std::istream& in, std::ostream& out)
+{
+    std::string textFilePath;
+    std::getline(in, textFilePath);
+
+    std::ifstream textFile{textFilePath, std::ios::binary};
+    std::string text{std::istreambuf_iterator<char>{textFile}, std::istreambuf_iterator<char>{}};
+
+    out << std::endl;
+    out << "Text: " << text.size() << " bytes, tokenized " << PASSES << " times" << std::endl;
+    out << std::endl;
+    out << "RESULTS" << std::endl;
+    out << "                      Tokens        Time  Tokens/sec   Bytes/sec" << std::endl;
+
+    Stopwatch stopwatch;
+
+    stopwatch.start();
+    Result expected = tokenize(text, nextWordWithIsAlnum);
+    stopwatch.stop();
+
+    printRow(out, "std::isalnum", expected, expected, stopwatch.lastDuration(), text.size());
+
+    for (WordTokenizer::Implementation implementation :
+        {WordTokenizer::Implementation::Scalar,
+         WordTokenizer::Implementation::SSE2,
+         WordTokenizer::Implementation::AVX2})
+    {
+        if (!WordTokenizer::isAvailable(implementation))
+        {
+            out << std::left << std::setw(16) << WordTokenizer::nameOf(implementation)
+                << "  (not supported)" << std::endl;
+
+            continue;
+        }
+
+        WordTokenizer tokenizer{implementation};
+
+        stopwatch.start();
+
+        Result result = tokenize(
+            text,
+            [&tokenizer](std::string_view text, std::size_t& index, std::size_t& start, std::size_t& length)
+            {
+                return tokenizer.nextWord(text, index, start, length);
+            });
+
+        stopwatch.stop();
+
+        printRow(out, WordTokenizer::nameOf(implementation), result, expected, stopwatch.lastDuration(), text.size());
+    }
+}
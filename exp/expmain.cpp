@@ -0,0 +1,68 @@
+// expmain.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Benchmarks that measure parts of the spell checker in isolation.  The
+// first line of standard input names the benchmark to run; the lines
+// after it are read by the benchmark itself (typically the paths to a
+// word file and a text file, in the same way that the shell asks for
+// them).
+
+#include <iostream>
+#include <string>
+#include "Benchmarks.hpp"
+
+
+int main()
+{
+    std::string benchmark;
+    std::getline(std::cin, benchmark);
+
+    if (benchmark == "ADDLATENCY")
+    {
+        runAddLatencyBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "ARENA")
+    {
+        runArenaBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "CANDIDATES")
+    {
+        runCandidateBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "CONCURRENT")
+    {
+        runConcurrentBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "DISTANCE")
+    {
+        runDistanceBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "FROZENBUILD")
+    {
+        runFrozenBuildBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "HASHCACHE")
+    {
+        runHashCacheBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "HASHRATE")
+    {
+        runHashRateBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "MEMORY")
+    {
+        runMemoryBenchmark(std::cin, std::cout);
+    }
+    else if (benchmark == "TOKENIZER")
+    {
+        runTokenizerBenchmark(std::cin, std::cout);
+    }
+    else
+    {
+        std::cout << "ERROR: Unknown benchmark: " << benchmark << std::endl;
+    }
+
+    return 0;
+}
@@ -21,7 +21,9 @@ class EmptySet : public Set<ElementType>
 public:
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
+    using Set<ElementType>::contains;
     virtual bool contains(const ElementType& element) const override;
+    virtual bool contains(std::string_view element) const override;
     virtual unsigned int size() const noexcept override;
 };
 
@@ -46,6 +48,13 @@ bool EmptySet<ElementType>::contains(const ElementType& element) const
 }
 
 
+template <typename ElementType>
+bool EmptySet<ElementType>::contains(std::string_view /* element */) const
+{
+    return false;
+}
+
+
 template <typename ElementType>
 unsigned int EmptySet<ElementType>::size() const noexcept
 {
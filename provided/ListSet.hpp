@@ -11,6 +11,9 @@
 #define LISTSET_HPP
 
 #include <algorithm>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include "Set.hpp"
 
 
@@ -28,7 +31,9 @@ public:
 
     virtual bool isImplemented() const noexcept override;
     virtual void add(const ElementType& element) override;
+    using Set<ElementType>::contains;
     virtual bool contains(const ElementType& element) const override;
+    virtual bool contains(std::string_view element) const override;
     virtual unsigned int size() const noexcept override;
 
 private:
@@ -144,6 +149,32 @@ bool ListSet<ElementType>::contains(const ElementType& element) const
 }
 
 
+template <typename ElementType>
+bool ListSet<ElementType>::contains(std::string_view element) const
+{
+    if constexpr (std::is_same_v<ElementType, std::string>)
+    {
+        Node* curr = head;
+
+        while (curr != nullptr)
+        {
+            if (curr->element == element)
+            {
+                return true;
+            }
+
+            curr = curr->next;
+        }
+
+        return false;
+    }
+    else
+    {
+        return Set<ElementType>::contains(element);
+    }
+}
+
+
 template <typename ElementType>
 unsigned int ListSet<ElementType>::size() const noexcept
 {
@@ -11,6 +11,8 @@
 #ifndef SET_HPP
 #define SET_HPP
 
+#include <string_view>
+#include <type_traits>
 
 
 template <typename ElementType>
@@ -34,16 +36,113 @@ public:
     virtual void add(const ElementType& element) = 0;
 
 
+    // bulkLoad() adds all of the elements in the range [first, last) to the
+    // set, as though add() had been called on each of them in turn.  This
+    // default implementation does just that; implementations that can do
+    // better when they know the elements all at once (e.g., by sizing a
+    // table once, or building a balanced tree from sorted elements)
+    // override it.
+    virtual void bulkLoad(const ElementType* first, const ElementType* last);
+
+
+    // reserve() is a hint that the set is about to hold at least the given
+    // number of elements, so that implementations that grow as elements
+    // are added can make room for all of them at once.  This default
+    // implementation ignores it.
+    virtual void reserve(unsigned int elementCount);
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.
     virtual bool contains(const ElementType& element) const = 0;
 
 
+    // contains() can also be asked about a std::string_view, so that callers
+    // who are building candidate words in a buffer of their own don't need to
+    // construct an ElementType just to ask.  This default implementation does
+    // construct one (or returns false when an ElementType can't be built from
+    // a string_view); implementations that store strings override it so that
+    // no allocation takes place.
+    virtual bool contains(std::string_view element) const;
+
+
+    // contains() can also be asked about a string literal, which would
+    // otherwise convert equally well to an ElementType or a std::string_view.
+    bool contains(const char* element) const;
+
+
+    // rollingHashBase() and containsHashed() let callers that look up many
+    // similar strings (such as a spell checker's edit candidates) hash them
+    // incrementally, rather than each one from scratch.  If the set finds
+    // elements by a polynomial "rolling" hash, in which the hash of the
+    // characters c[0], c[1], ..., c[n - 1] is the sum of each c[i] times
+    // base^(n - 1 - i), as an unsigned int, then rollingHashBase() returns
+    // the base; otherwise, it returns 0.  containsHashed() is like
+    // contains(), except that it's also given that hash of the element,
+    // so it needn't calculate it.  These default implementations use no
+    // such hash, so containsHashed() ignores the one it's given.
+    virtual unsigned int rollingHashBase() const noexcept;
+    virtual bool containsHashed(unsigned int hash, std::string_view element) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept = 0;
 };
 
 
 
+template <typename ElementType>
+void Set<ElementType>::bulkLoad(const ElementType* first, const ElementType* last)
+{
+    for (; first != last; ++first)
+    {
+        add(*first);
+    }
+}
+
+
+template <typename ElementType>
+void Set<ElementType>::reserve(unsigned int /* elementCount */)
+{
+}
+
+
+template <typename ElementType>
+bool Set<ElementType>::contains(std::string_view element) const
+{
+    if constexpr (std::is_constructible_v<ElementType, std::string_view>)
+    {
+        return contains(ElementType{element});
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template <typename ElementType>
+bool Set<ElementType>::contains(const char* element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+
+template <typename ElementType>
+unsigned int Set<ElementType>::rollingHashBase() const noexcept
+{
+    return 0;
+}
+
+
+template <typename ElementType>
+bool Set<ElementType>::containsHashed(unsigned int /* hash */, std::string_view element) const
+{
+    return contains(element);
+}
+
+
+
 #endif // SET_HPP
 
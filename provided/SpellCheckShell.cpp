@@ -7,18 +7,31 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 #include "SpellCheckShell.hpp"
 #include "AVLSet.hpp"
+#include "BloomFilter.hpp"
+#include "BTreeSet.hpp"
+#include "CompiledWordSet.hpp"
+#include "ConcurrentHashSet.hpp"
 #include "EmptySet.hpp"
+#include "EytzingerSet.hpp"
+#include "FlatHashSet.hpp"
+#include "FrozenHashSet.hpp"
 #include "HashSet.hpp"
 #include "ListSet.hpp"
+#include "MappedTextFileReader.hpp"
 #include "OutputSpellCheckerListener.hpp"
 #include "Set.hpp"
 #include "SkipListSet.hpp"
 #include "SpellChecker.hpp"
 #include "Stopwatch.hpp"
 #include "StringHashing.hpp"
+#include "SuggestionIndex.hpp"
 #include "TextFileReader.hpp"
+#include "TrieSet.hpp"
 #include "WordChecker.hpp"
 #include "WordSetLoader.hpp"
 
@@ -53,21 +66,53 @@ namespace
         {
             return std::make_unique<AVLSet<std::string>>();
         }
+        else if (setType == "BTREE")
+        {
+            return std::make_unique<BTreeSet>();
+        }
+        else if (setType == "COMPILED")
+        {
+            return std::make_unique<CompiledWordSet>();
+        }
+        else if (setType == "CONCURRENT HASH PRODUCT")
+        {
+            return std::make_unique<ConcurrentHashSet<std::string>>(hashStringAsProduct, hashStringAsProduct);
+        }
         else if (setType == "EMPTY")
         {
             return std::make_unique<EmptySet<std::string>>();
         }
+        else if (setType == "EYTZINGER")
+        {
+            return std::make_unique<EytzingerSet<std::string>>();
+        }
+        else if (setType == "FLAT HASH PRODUCT")
+        {
+            return std::make_unique<FlatHashSet<std::string>>(hashStringAsProduct, hashStringAsProduct);
+        }
+        else if (setType == "FLAT HASH WY")
+        {
+            return std::make_unique<FlatHashSet<std::string>>(hashStringAsWy, hashStringAsWy);
+        }
+        else if (setType == "FROZEN")
+        {
+            return std::make_unique<FrozenHashSet>();
+        }
         else if (setType == "HASH ZERO")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsZero);
+            return std::make_unique<HashSet<std::string, ZeroHashPolicy>>();
         }
         else if (setType == "HASH SUM")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsSum);
+            return std::make_unique<HashSet<std::string, SumHashPolicy>>();
         }
         else if (setType == "HASH PRODUCT")
         {
-            return std::make_unique<HashSet<std::string>>(hashStringAsProduct);
+            return std::make_unique<HashSet<std::string, ProductHashPolicy>>();
+        }
+        else if (setType == "HASH WY")
+        {
+            return std::make_unique<HashSet<std::string, WyHashPolicy>>();
         }
         else if (setType == "LIST")
         {
@@ -77,6 +122,10 @@ namespace
         {
             return std::make_unique<SkipListSet<std::string>>();
         }
+        else if (setType == "TRIE")
+        {
+            return std::make_unique<TrieSet>();
+        }
         else
         {
             throw SpellCheckShell::ShellException{"Invalid search structure type: " + setType};
@@ -108,6 +157,32 @@ namespace
     }
 
 
+    void requireValidImageIfCompiled(const std::string& filePath)
+    {
+        if (CompiledWordSet::isImage(filePath) && !CompiledWordSet{}.open(filePath))
+        {
+            throw SpellCheckShell::ShellException{
+                "Compiled word set is damaged or from another version: " + filePath};
+        }
+    }
+
+
+    // An output type is DISPLAY or TIME, which can be followed by these
+    // options (in either order):
+    //
+    //   * INDEXED, which builds a SuggestionIndex from the word set, which
+    //     the WordChecker then uses to find its suggestions
+    //   * THREADS n, which checks the text on n threads; the timing test
+    //     also reports how the checking scales from 1 thread up to n
+    //   * MAPPED, which reads the text through a MappedTextFileReader, so
+    //     that the words are checked without being copied (this applies
+    //     only when the text is checked on the calling thread, since the
+    //     threads already share the work of copying it)
+    //   * BLOOM n, which builds a BloomFilter with n bits per word from the
+    //     word set, which the WordChecker asks about each candidate before
+    //     the word set; the timing test also reports how well it filtered
+    //     and how much time it saved
+
     enum class OutputType
     {
         Display,
@@ -115,26 +190,94 @@ namespace
     };
 
 
-    OutputType makeOutputType(const std::string& outputType)
+    struct OutputOptions
     {
-        if (outputType == "DISPLAY")
+        OutputType type;
+        bool indexed;
+        unsigned int threads;
+        bool mapped;
+        unsigned int bloomBitsPerWord;
+    };
+
+
+    OutputOptions makeOutputOptions(const std::string& outputType)
+    {
+        std::istringstream in{outputType};
+        std::string token;
+
+        OutputOptions options{OutputType::Display, false, 0, false, 0};
+
+        in >> token;
+
+        if (token == "DISPLAY")
         {
-            return OutputType::Display;
+            options.type = OutputType::Display;
         }
-        else if (outputType == "TIME")
+        else if (token == "TIME")
         {
-            return OutputType::TimeOnly;
+            options.type = OutputType::TimeOnly;
         }
         else
         {
             throw SpellCheckShell::ShellException{"Invalid output type: " + outputType};
         }
+
+        while (in >> token)
+        {
+            if (token == "INDEXED" && !options.indexed)
+            {
+                options.indexed = true;
+            }
+            else if (token == "MAPPED" && !options.mapped)
+            {
+                options.mapped = true;
+            }
+            else if (token == "THREADS" && options.threads == 0
+                && in >> options.threads && options.threads > 0)
+            {
+            }
+            else if (token == "BLOOM" && options.bloomBitsPerWord == 0
+                && in >> options.bloomBitsPerWord && options.bloomBitsPerWord > 0)
+            {
+            }
+            else
+            {
+                throw SpellCheckShell::ShellException{"Invalid output type: " + outputType};
+            }
+        }
+
+        return options;
+    }
+
+
+    // checkSpelling() checks the text file on the calling thread if threads
+    // is 0 (mapping it into memory if mapped is true), or in parallel on
+    // that many threads otherwise.
+    void checkSpelling(
+        SpellChecker& spellChecker, const WordChecker& wordChecker,
+        const std::string& textFilePath, unsigned int threads, bool mapped)
+    {
+        if (threads == 0 && mapped)
+        {
+            MappedTextFileReader reader{textFilePath};
+            spellChecker.run(wordChecker, reader);
+        }
+        else if (threads == 0)
+        {
+            TextFileReader reader{textFilePath};
+            spellChecker.run(wordChecker, reader);
+        }
+        else
+        {
+            spellChecker.runParallel(wordChecker, textFilePath, threads);
+        }
     }
 
 
     void runWithDisplay(
         Set<std::string>& wordSet,
-        const std::string& wordFilePath, const std::string& textFilePath)
+        const std::string& wordFilePath, const std::string& textFilePath,
+        const OutputOptions& options)
     {
         SpellChecker spellChecker;
 
@@ -146,20 +289,40 @@ namespace
         std::cout << std::endl;
         std::cout << "Loading word set from " << wordFilePath << " ..." << std::endl;
 
-        WordSetLoader{}.load(wordFilePath, wordSet);
+        SuggestionIndex index;
+        BloomFilter filter{options.bloomBitsPerWord};
+        bool filtered = options.bloomBitsPerWord > 0;
+
+        WordSetLoader{}.load(
+            wordFilePath, wordSet, options.indexed ? &index : nullptr, filtered ? &filter : nullptr);
+
+        if (options.indexed)
+        {
+            index.build();
+        }
+
+        if (filtered)
+        {
+            filter.build();
+        }
 
         std::cout << "Checking spelling in " << textFilePath << " ..." << std::endl;
 
-        WordChecker wordChecker{wordSet};
-        TextFileReader reader{textFilePath};
+        WordChecker wordChecker = options.indexed ? WordChecker{wordSet, index} : WordChecker{wordSet};
+
+        if (filtered)
+        {
+            wordChecker.usePrefilter(filter);
+        }
 
-        spellChecker.run(wordChecker, reader);
+        checkSpelling(spellChecker, wordChecker, textFilePath, options.threads, options.mapped);
     }
 
 
     void runTimingTest(
         Set<std::string>& wordSet,
-        const std::string& wordFilePath, const std::string& textFilePath)
+        const std::string& wordFilePath, const std::string& textFilePath,
+        const OutputOptions& options)
     {
         std::cout << std::endl;
 
@@ -170,22 +333,59 @@ namespace
         std::cout << "Loading word set from " << wordFilePath
                   << " into search structure ..." << std::endl;
 
+        SuggestionIndex index;
+        BloomFilter filter{options.bloomBitsPerWord};
+        bool filtered = options.bloomBitsPerWord > 0;
+
         {
             stopwatch.start();
-            WordSetLoader{}.load(wordFilePath, wordSet);
+
+            WordSetLoader{}.load(
+                wordFilePath, wordSet, options.indexed ? &index : nullptr, filtered ? &filter : nullptr);
+
             stopwatch.stop();
         }
 
         double wordSetLoadDuration = stopwatch.lastDuration();
+        double indexBuildDuration = 0.0;
+
+        if (options.indexed)
+        {
+            std::cout << "Building suggestion index ..." << std::endl;
+
+            stopwatch.start();
+            index.build();
+            stopwatch.stop();
+
+            indexBuildDuration = stopwatch.lastDuration();
+        }
+
+        double filterBuildDuration = 0.0;
+
+        if (filtered)
+        {
+            std::cout << "Building prefilter ..." << std::endl;
+
+            stopwatch.start();
+            filter.build();
+            stopwatch.stop();
+
+            filterBuildDuration = stopwatch.lastDuration();
+        }
 
         std::cout << "Checking spelling of words in " << textFilePath
                   << " using search structure ..." << std::endl;
 
+        WordChecker wordChecker = options.indexed ? WordChecker{wordSet, index} : WordChecker{wordSet};
+
+        if (filtered)
+        {
+            wordChecker.usePrefilter(filter);
+        }
+
         {
             stopwatch.start();
-            WordChecker wordChecker{wordSet};
-            TextFileReader reader{textFilePath};
-            spellChecker.run(wordChecker, reader);
+            checkSpelling(spellChecker, wordChecker, textFilePath, options.threads, options.mapped);
             stopwatch.stop();
         }
 
@@ -208,9 +408,8 @@ namespace
 
         {
             stopwatch.start();
-            WordChecker wordChecker{emptySet};
-            TextFileReader reader{textFilePath};
-            spellChecker.run(wordChecker, reader);
+            WordChecker emptyWordChecker{emptySet};
+            checkSpelling(spellChecker, emptyWordChecker, textFilePath, options.threads, options.mapped);
             stopwatch.stop();
         }
 
@@ -261,6 +460,155 @@ namespace
                      - (emptySetLoadDuration + emptySetSpellCheckDuration) << "usec";
 
         std::cout << std::endl;
+
+        if (options.indexed)
+        {
+            std::cout << std::endl;
+            std::cout << "               BuildTime         Memory            Entries" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Index";
+
+            std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                      << indexBuildDuration << "usec";
+
+            std::cout << std::right << std::setw(11)
+                      << index.memoryUsage() << "bytes";
+
+            std::cout << std::right << std::setw(14)
+                      << index.entryCount();
+
+            std::cout << std::endl;
+        }
+
+        if (const FrozenHashSet* frozen = dynamic_cast<const FrozenHashSet*>(&wordSet))
+        {
+            std::cout << std::endl;
+            std::cout << "                 Buckets          Memory   PilotBitsPerWord  Attempts" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Perfect Hash";
+
+            std::cout << std::right << std::setw(12) << frozen->bucketCount();
+
+            std::cout << std::right << std::setw(11)
+                      << frozen->memoryUsage() << "bytes";
+
+            std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(19)
+                      << (frozen->size() > 0 ? 32.0 * frozen->bucketCount() / frozen->size() : 0.0);
+
+            std::cout << std::right << std::setw(10) << frozen->buildAttempts();
+
+            std::cout << std::endl;
+        }
+
+        if (filtered)
+        {
+            // The filter's effect is measured on the calling thread, so that
+            // one WordChecker sees all of the candidates, with and without it.
+            WordChecker unfilteredChecker = options.indexed ? WordChecker{wordSet, index} : WordChecker{wordSet};
+            WordChecker filteredChecker = unfilteredChecker;
+            filteredChecker.usePrefilter(filter);
+
+            stopwatch.start();
+            checkSpelling(spellChecker, unfilteredChecker, textFilePath, 0, options.mapped);
+            stopwatch.stop();
+
+            double unfilteredDuration = stopwatch.lastDuration();
+
+            stopwatch.start();
+            checkSpelling(spellChecker, filteredChecker, textFilePath, 0, options.mapped);
+            stopwatch.stop();
+
+            double filteredDuration = stopwatch.lastDuration();
+
+            const PrefilterStats& stats = filteredChecker.prefilterStats();
+            unsigned long long nonWords = stats.rejected + stats.falsePositives;
+
+            std::cout << std::endl;
+            std::cout << "               BuildTime         Memory        BitsPerWord    Hashes" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Prefilter";
+
+            std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                      << filterBuildDuration << "usec";
+
+            std::cout << std::right << std::setw(11)
+                      << filter.memoryUsage() << "bytes";
+
+            std::cout << std::right << std::setw(14) << filter.bitsPerWord();
+            std::cout << std::right << std::setw(10) << filter.hashCount();
+
+            std::cout << std::endl;
+
+            std::cout << std::endl;
+            std::cout << "     Lookups      Rejected  FalsePositives    FalsePositiveRate    Expected" << std::endl;
+
+            std::cout << std::right << std::setw(12) << stats.lookups;
+            std::cout << std::right << std::setw(14) << stats.rejected;
+            std::cout << std::right << std::setw(16) << stats.falsePositives;
+
+            std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(20)
+                      << (nonWords > 0 ? 100.0 * stats.falsePositives / nonWords : 0.0) << "%";
+
+            std::cout << std::right << std::fixed << std::setprecision(3) << std::setw(11)
+                      << 100.0 * filter.expectedFalsePositiveRate() << "%";
+
+            std::cout << std::endl;
+
+            std::cout << std::endl;
+            std::cout << "            SpellCheckTime" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Unfiltered";
+            std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                      << unfilteredDuration << "usec" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Filtered";
+            std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                      << filteredDuration << "usec" << std::endl;
+
+            std::cout << std::left << std::setw(12) << "Saved";
+            std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                      << (unfilteredDuration - filteredDuration) << "usec" << std::endl;
+        }
+
+        if (options.threads > 0)
+        {
+            std::vector<unsigned int> threadCounts;
+
+            for (unsigned int threads = 1; threads < options.threads; threads *= 2)
+            {
+                threadCounts.push_back(threads);
+            }
+
+            threadCounts.push_back(options.threads);
+
+            std::cout << std::endl;
+            std::cout << "Threads   SpellCheckTime   Speedup" << std::endl;
+
+            double oneThreadDuration = 0.0;
+
+            for (unsigned int threads : threadCounts)
+            {
+                stopwatch.start();
+                checkSpelling(spellChecker, wordChecker, textFilePath, threads, options.mapped);
+                stopwatch.stop();
+
+                if (threads == 1)
+                {
+                    oneThreadDuration = stopwatch.lastDuration();
+                }
+
+                std::cout << std::left << std::setw(8) << threads;
+
+                std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12)
+                          << stopwatch.lastDuration() << "usec";
+
+                std::cout << std::right << std::fixed << std::setprecision(2) << std::setw(9)
+                          << (stopwatch.lastDuration() > 0.0 ? oneThreadDuration / stopwatch.lastDuration() : 0.0)
+                          << "x";
+
+                std::cout << std::endl;
+            }
+        }
     }
 }
 
@@ -268,7 +616,15 @@ namespace
 
 void SpellCheckShell::run()
 {
-    std::unique_ptr<Set<std::string>> wordSet = makeWordSet(readString());
+    std::string setType = readString();
+
+    if (setType == "COMPILE")
+    {
+        compileWordSet();
+        return;
+    }
+
+    std::unique_ptr<Set<std::string>> wordSet = makeWordSet(setType);
 
     if (!wordSet->isImplemented())
     {
@@ -278,21 +634,49 @@ void SpellCheckShell::run()
 
     std::string wordFilePath = readString();
     requireNonEmptyFileExists(wordFilePath);
+    requireValidImageIfCompiled(wordFilePath);
 
     std::string textFilePath = readString();
     requireNonEmptyFileExists(textFilePath);
 
-    OutputType outputType = makeOutputType(readString());
+    OutputOptions options = makeOutputOptions(readString());
 
-    switch (outputType)
+    switch (options.type)
     {
     case OutputType::Display:
-        runWithDisplay(*wordSet, wordFilePath, textFilePath);
+        runWithDisplay(*wordSet, wordFilePath, textFilePath, options);
         break;
 
     case OutputType::TimeOnly:
-        runTimingTest(*wordSet, wordFilePath, textFilePath);
+        runTimingTest(*wordSet, wordFilePath, textFilePath, options);
         break;
     }
 }
 
+
+// Rather than a search structure type, the first line of input can be
+// COMPILE, followed by the path to a word file and the path to write a
+// compiled image of it to.  The image can then be given in place of the
+// word file, with any search structure type; with COMPILED, it's searched
+// directly, without being loaded at all.
+
+void SpellCheckShell::compileWordSet()
+{
+    std::string wordFilePath = readString();
+    requireNonEmptyFileExists(wordFilePath);
+
+    std::string imagePath = readString();
+
+    try
+    {
+        unsigned int wordCount = WordSetLoader{}.compile(wordFilePath, imagePath);
+
+        std::cout << "Compiled " << wordCount << " words from " << wordFilePath
+                  << " into " << imagePath << std::endl;
+    }
+    catch (std::exception& e)
+    {
+        throw SpellCheckShell::ShellException{e.what()};
+    }
+}
+
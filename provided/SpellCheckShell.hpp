@@ -17,6 +17,10 @@ class SpellCheckShell
 public:
     void run();
 
+private:
+    void compileWordSet();
+
+public:
 
     class ShellException
     {
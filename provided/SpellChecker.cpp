@@ -3,7 +3,83 @@
 // ICS 46 Winter 2019
 // Project #3: Set the Controls for the Heart of the Sun
 
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
 #include "SpellChecker.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace
+{
+    // The number of bytes of text (give or take a line) in each chunk
+    // handed to a thread.
+    constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    // The number of chunks that may be in flight at once, per thread, which
+    // bounds how much of the file is in memory at any given time.
+    constexpr unsigned int CHUNKS_PER_THREAD = 4;
+
+
+    struct Misspelling
+    {
+        std::size_t line;
+        std::string word;
+        std::vector<std::string> suggestions;
+    };
+
+
+    struct Chunk
+    {
+        std::vector<std::string> lines;
+        std::vector<Misspelling> misspellings;
+    };
+
+
+    // readChunk() reads whole lines from the file into the chunk until it
+    // holds at least CHUNK_SIZE bytes or the file runs out.  It returns
+    // false if no lines could be read.
+    bool readChunk(std::istream& textFile, Chunk& chunk)
+    {
+        std::size_t bytes = 0;
+        std::string line;
+
+        while (bytes < CHUNK_SIZE && std::getline(textFile, line))
+        {
+            bytes += line.size() + 1;
+            chunk.lines.push_back(std::move(line));
+        }
+
+        return !chunk.lines.empty();
+    }
+
+
+    // checkChunk() is given its own copy of the WordChecker, since a
+    // WordChecker keeps scratch space from one call to the next.
+    void checkChunk(WordChecker wordChecker, Chunk& chunk)
+    {
+        std::string word;
+
+        for (std::size_t line = 0; line < chunk.lines.size(); ++line)
+        {
+            std::size_t index = 0;
+
+            while (TextFileReader::nextWordInLine(chunk.lines[line], index, word))
+            {
+                if (!wordChecker.wordExists(word))
+                {
+                    chunk.misspellings.push_back(
+                        Misspelling{line, word, wordChecker.findSuggestions(word)});
+                }
+            }
+        }
+    }
+}
 
 
 
@@ -23,6 +99,85 @@ void SpellChecker::run(const WordChecker& wordChecker, TextFileReader& reader)
 }
 
 
+void SpellChecker::run(const WordChecker& wordChecker, MappedTextFileReader& reader)
+{
+    while (!reader.noMoreWords())
+    {
+        if (!wordChecker.wordExists(reader.currentWord()))
+        {
+            std::string word{reader.currentWord()};
+
+            notifyMisspellingFound(
+                word, std::string{reader.currentLine()},
+                wordChecker.findSuggestions(word));
+        }
+
+        reader.advanceToNextWord();
+    }
+}
+
+
+// Chunks are submitted to the thread pool in the order they're read, and
+// their results are delivered in that same order: the calling thread always
+// waits for the oldest chunk in flight, notifies observers about it, and
+// then reads another chunk to take its place.
+
+void SpellChecker::runParallel(
+    const WordChecker& wordChecker, const std::string& textFilePath,
+    unsigned int threadCount)
+{
+    std::ifstream textFile{textFilePath};
+
+    // The chunks in flight are declared before the pool, so that the pool
+    // (and any tasks still using the chunks) is destroyed first, should an
+    // exception be thrown.
+    std::deque<std::pair<std::unique_ptr<Chunk>, std::future<void>>> inFlight;
+    ThreadPool pool{threadCount};
+
+    std::size_t maxInFlight = static_cast<std::size_t>(pool.threadCount()) * CHUNKS_PER_THREAD;
+    bool moreText = true;
+
+    while (true)
+    {
+        while (moreText && inFlight.size() < maxInFlight)
+        {
+            std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+            moreText = readChunk(textFile, *chunk);
+
+            if (moreText)
+            {
+                Chunk* toCheck = chunk.get();
+
+                std::future<void> done = pool.submit(
+                    [&wordChecker, toCheck]
+                    {
+                        checkChunk(wordChecker, *toCheck);
+                    });
+
+                inFlight.emplace_back(std::move(chunk), std::move(done));
+            }
+        }
+
+        if (inFlight.empty())
+        {
+            break;
+        }
+
+        inFlight.front().second.get();
+
+        const Chunk& chunk = *inFlight.front().first;
+
+        for (const Misspelling& misspelling : chunk.misspellings)
+        {
+            notifyMisspellingFound(
+                misspelling.word, chunk.lines[misspelling.line], misspelling.suggestions);
+        }
+
+        inFlight.pop_front();
+    }
+}
+
+
 void SpellChecker::notifyMisspellingFound(
     const std::string& word, const std::string& line,
     const std::vector<std::string>& suggestions)
@@ -7,12 +7,22 @@
 // WordChecker to determine whether words are spelled correctly,
 // the given TextFileReader to determine which words to check,
 // and notifies any observers whenever misspellings are found.
+//
+// It can also check a text file in parallel, splitting it into chunks of
+// whole lines that are checked on a pool of threads, while still notifying
+// observers (on the calling thread) in the order the misspellings appear.
+//
+// Given a MappedTextFileReader instead of a TextFileReader, it checks the
+// words where they lie in the mapped file, only copying the words that are
+// misspelled (and their lines) in order to notify observers about them.
 
 #ifndef SPELLCHECKER_HPP
 #define SPELLCHECKER_HPP
 
+#include <string>
 #include <ics46/observable/Observable.hpp>
 #include "SpellCheckerListener.hpp"
+#include "MappedTextFileReader.hpp"
 #include "TextFileReader.hpp"
 #include "WordChecker.hpp"
 
@@ -22,6 +32,15 @@ class SpellChecker : public ics46::observable::Observable<SpellCheckerListener>
 {
 public:
     void run(const WordChecker& wordChecker, TextFileReader& reader);
+    void run(const WordChecker& wordChecker, MappedTextFileReader& reader);
+
+    // runParallel() checks the given text file using the given number of
+    // threads, each with its own copy of the WordChecker.  The Set that the
+    // WordChecker uses is shared by the threads, so it must not be changed
+    // while this function runs.
+    void runParallel(
+        const WordChecker& wordChecker, const std::string& textFilePath,
+        unsigned int threadCount);
 
 private:
     void notifyMisspellingFound(
@@ -7,46 +7,111 @@
 
 
 
-// This hash function returns zero for all strings.  As you might imagine,
-// this isn't a very good choice in practice; try it and see what happens.
+// The three 32-bit hash functions are the same as the hash policies
+// declared in StringHashing.hpp, which is where they're explained.
 
-unsigned int hashStringAsZero(const std::string& word)
+unsigned int hashStringAsZero(std::string_view word)
 {
-    return 0;
+    return ZeroHashPolicy{}(word);
 }
 
 
-// This hash function returns a hash value calculated by summing the
-// character codes of each character in the string.  Consider whether
-// this is a good approach, and compare it to the hash function below.
+unsigned int hashStringAsSum(std::string_view word)
+{
+    return SumHashPolicy{}(word);
+}
+
 
-unsigned int hashStringAsSum(const std::string& word)
+unsigned int hashStringAsProduct(std::string_view word)
 {
-    unsigned int hash = 0;
+    return ProductHashPolicy{}(word);
+}
+
+
+// This hash function is the 64-bit variant of the Fowler-Noll-Vo "FNV-1a"
+// hash: each character is XORed into the hash, which is then multiplied by
+// a large prime.  It's a simple hash, but the XOR-then-multiply order
+// spreads each character's influence across the whole hash well.
+
+std::uint64_t hashStringAsFnv1a64(std::string_view word)
+{
+    std::uint64_t hash = 14695981039346656037ull;
 
     for (size_t i = 0; i < word.length(); ++i)
     {
-        hash += static_cast<unsigned int>(word[i]);
+        hash ^= static_cast<unsigned char>(word[i]);
+        hash *= 1099511628211ull;
     }
 
     return hash;
 }
 
 
-// This hash function returns a hash value calculated in a way that
-// includes multiplication by the prime number 37 repeatedly.  Consider
-// why this approach might be better or worse than the one above.
+std::uint64_t hashStringAsWy64(std::string_view word, std::uint64_t seed)
+{
+    return impl_::wyHash(word, seed);
+}
+
+
+unsigned int hashStringAsWy(std::string_view word)
+{
+    return WyHashPolicy{}(word);
+}
+
+
+// The batch is hashed LANES words at a time.  Words of up to 16
+// characters (nearly all of them, in practice) go through each step of
+// the hash together, one lane per word; the rare longer word is hashed on
+// its own.  The multiplications can't be done in SIMD registers, since
+// neither SSE nor AVX2 has a 64-by-64-bit multiplication, but with the
+// lanes independent of one another, the processor can have several of
+// them in flight at once.
 
-unsigned int hashStringAsProduct(const std::string& word)
+void hashStringsAsWy64(
+    const std::string_view* words, std::size_t count,
+    std::uint64_t* hashes, std::uint64_t seed)
 {
-    unsigned int hash = 0;
+    constexpr std::size_t LANES = 4;
 
-    for (size_t i = 0; i < word.length(); ++i)
+    std::uint64_t mixedSeed = impl_::wySeed(seed);
+    std::size_t i = 0;
+
+    for (; i + LANES <= count; i += LANES)
     {
-        hash *= 37;
-        hash += static_cast<unsigned int>(word[i]);
+        const std::string_view* lanes = words + i;
+        bool allShort = true;
+
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            allShort = allShort && lanes[lane].size() <= 16;
+        }
+
+        if (!allShort)
+        {
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                hashes[i + lane] = impl_::wyHash(lanes[lane], seed);
+            }
+
+            continue;
+        }
+
+        std::uint64_t a[LANES];
+        std::uint64_t b[LANES];
+
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            impl_::wyShortInput(lanes[lane].data(), lanes[lane].size(), a[lane], b[lane]);
+        }
+
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            hashes[i + lane] = impl_::wyFinish(a[lane], b[lane], mixedSeed, lanes[lane].size());
+        }
     }
 
-    return hash;
+    for (; i < count; ++i)
+    {
+        hashes[i] = impl_::wyHash(words[i], seed);
+    }
 }
-
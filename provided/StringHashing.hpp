@@ -4,17 +4,286 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A collection of hash functions that are capable of hashing strings.
+// They accept a std::string_view, so they can hash a std::string or
+// any other run of characters (such as a candidate word being built in
+// a buffer) without it first having to be copied into a std::string.
 
 #ifndef STRINGHASHING_HPP
 #define STRINGHASHING_HPP
 
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
 
 
 
-unsigned int hashStringAsZero(const std::string& word);
-unsigned int hashStringAsSum(const std::string& word);
-unsigned int hashStringAsProduct(const std::string& word);
+unsigned int hashStringAsZero(std::string_view word);
+unsigned int hashStringAsSum(std::string_view word);
+unsigned int hashStringAsProduct(std::string_view word);
+
+// Each hash policy is a type whose objects hash a string the same way as
+// the corresponding function above.  Unlike a function pointer or a
+// std::function, the type itself says which hash is used, so a HashSet
+// given one as its HashPolicy can inline it.
+
+struct ZeroHashPolicy
+{
+    unsigned int operator()(std::string_view word) const noexcept;
+};
+
+
+// The sum and product hashes are both rolling hashes, which a HashSet
+// can take advantage of (see Set::rollingHashBase()), so their policies
+// say which base they use.
+
+struct SumHashPolicy
+{
+    static constexpr unsigned int ROLLING_HASH_BASE = 1;
+
+    unsigned int operator()(std::string_view word) const noexcept;
+};
+
+
+struct ProductHashPolicy
+{
+    static constexpr unsigned int ROLLING_HASH_BASE = 37;
+
+    unsigned int operator()(std::string_view word) const noexcept;
+};
+
+
+struct WyHashPolicy
+{
+    unsigned int operator()(std::string_view word) const noexcept;
+};
+
+
+// A 64-bit hash, for uses (such as fingerprinting) where 32 bits
+// would collide too often.
+std::uint64_t hashStringAsFnv1a64(std::string_view word);
+
+
+// A fast, high-quality family of 64-bit hashes, based on wyhash: rather
+// than one character at a time, it reads the string up to 16 bytes at a
+// time and mixes them in with 64-by-64-bit multiplications.  Each seed
+// gives a different (and independent) member of the family.
+std::uint64_t hashStringAsWy64(std::string_view word, std::uint64_t seed = 0);
+
+// The 32-bit version folds the two halves of the 64-bit hash together.
+unsigned int hashStringAsWy(std::string_view word);
+
+// Hashes count words at once, storing hashStringAsWy64(words[i], seed)
+// into hashes[i].  The words are hashed several at a time, in lanes whose
+// steps are interleaved, so that their multiplications can overlap rather
+// than each waiting for the one before it; this suits hashing a batch of
+// similar candidates, such as the 26 that a spell checker gets by
+// inserting or replacing one letter at the same position.
+void hashStringsAsWy64(
+    const std::string_view* words, std::size_t count,
+    std::uint64_t* hashes, std::uint64_t seed = 0);
+
+
+
+// This hash returns zero for all strings.  As you might imagine, this
+// isn't a very good choice in practice; try it and see what happens.
+
+inline unsigned int ZeroHashPolicy::operator()(std::string_view /* word */) const noexcept
+{
+    return 0;
+}
+
+
+// This hash is calculated by summing the character codes of each
+// character in the string.  Consider whether this is a good approach,
+// and compare it to the hash below.
+
+inline unsigned int SumHashPolicy::operator()(std::string_view word) const noexcept
+{
+    unsigned int hash = 0;
+
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        hash += static_cast<unsigned int>(word[i]);
+    }
+
+    return hash;
+}
+
+
+// This hash is calculated in a way that includes multiplication by the
+// prime number 37 repeatedly.  Consider why this approach might be better
+// or worse than the one above.
+
+inline unsigned int ProductHashPolicy::operator()(std::string_view word) const noexcept
+{
+    unsigned int hash = 0;
+
+    for (size_t i = 0; i < word.length(); ++i)
+    {
+        hash *= ROLLING_HASH_BASE;
+        hash += static_cast<unsigned int>(word[i]);
+    }
+
+    return hash;
+}
+
+
+
+
+namespace impl_
+{
+    // The constants, and the way they're used, are those of wyhash's final
+    // version 4, so hashStringAsWy64() gives the same hashes as wyhash
+    // does with its default secret.
+    constexpr std::uint64_t WY_SECRET[4] =
+    {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+
+
+    // wyMultiply() replaces a and b with the low and high halves of their
+    // 128-bit product, and wyMix() combines them by XOR.
+
+    inline void wyMultiply(std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<std::uint64_t>(product);
+        b = static_cast<std::uint64_t>(product >> 64);
+    }
+
+
+    inline std::uint64_t wyMix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+        wyMultiply(a, b);
+        return a ^ b;
+    }
+
+
+    inline std::uint64_t wyRead8(const char* p) noexcept
+    {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+
+    inline std::uint64_t wyRead4(const char* p) noexcept
+    {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+
+    inline std::uint64_t wySeed(std::uint64_t seed) noexcept
+    {
+        return seed ^ wyMix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    }
+
+
+    // wyShortInput() reads a string of at most 16 characters into the two
+    // 64-bit words a and b; strings of 4 or more characters are read as
+    // (possibly overlapping) 4-byte pieces, so no character is read twice
+    // unless it has to be, and nothing outside the string is read at all.
+
+    inline void wyShortInput(const char* p, std::size_t length, std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+        if (length >= 4)
+        {
+            std::size_t middle = (length >> 3) << 2;
+            a = (wyRead4(p) << 32) | wyRead4(p + middle);
+            b = (wyRead4(p + length - 4) << 32) | wyRead4(p + length - 4 - middle);
+        }
+        else if (length > 0)
+        {
+            a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[length >> 1])) << 8)
+                | static_cast<unsigned char>(p[length - 1]);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+
+
+    // wyLongInput() mixes a string of more than 16 characters into the
+    // (already seeded) seed, 48 and then 16 characters at a time, leaving
+    // its last 16 characters in a and b.
+
+    inline void wyLongInput(
+        const char* p, std::size_t length, std::uint64_t& seed, std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+        std::size_t i = length;
+
+        if (i >= 48)
+        {
+            std::uint64_t seed1 = seed;
+            std::uint64_t seed2 = seed;
+
+            do
+            {
+                seed = wyMix(wyRead8(p) ^ WY_SECRET[1], wyRead8(p + 8) ^ seed);
+                seed1 = wyMix(wyRead8(p + 16) ^ WY_SECRET[2], wyRead8(p + 24) ^ seed1);
+                seed2 = wyMix(wyRead8(p + 32) ^ WY_SECRET[3], wyRead8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            }
+            while (i >= 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (i > 16)
+        {
+            seed = wyMix(wyRead8(p) ^ WY_SECRET[1], wyRead8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+
+        a = wyRead8(p + i - 16);
+        b = wyRead8(p + i - 8);
+    }
+
+
+    inline std::uint64_t wyFinish(std::uint64_t a, std::uint64_t b, std::uint64_t seed, std::size_t length) noexcept
+    {
+        a ^= WY_SECRET[1];
+        b ^= seed;
+        wyMultiply(a, b);
+        return wyMix(a ^ WY_SECRET[0] ^ length, b ^ WY_SECRET[1]);
+    }
+
+
+    inline std::uint64_t wyHash(std::string_view word, std::uint64_t seed) noexcept
+    {
+        seed = wySeed(seed);
+
+        std::uint64_t a;
+        std::uint64_t b;
+
+        if (word.size() <= 16)
+        {
+            wyShortInput(word.data(), word.size(), a, b);
+        }
+        else
+        {
+            wyLongInput(word.data(), word.size(), seed, a, b);
+        }
+
+        return wyFinish(a, b, seed, word.size());
+    }
+}
+
+
+inline unsigned int WyHashPolicy::operator()(std::string_view word) const noexcept
+{
+    std::uint64_t hash = impl_::wyHash(word, 0);
+    return static_cast<unsigned int>(hash ^ (hash >> 32));
+}
 
 
 
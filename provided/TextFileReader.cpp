@@ -5,6 +5,7 @@
 
 #include <cctype>
 #include "TextFileReader.hpp"
+#include "WordTokenizer.hpp"
 
 
 TextFileReader::TextFileReader(const std::string& textFilePath)
@@ -26,33 +27,45 @@ void TextFileReader::advanceToNextWord()
 
     while (!eof)
     {
-        while (lineIndex < line.length() && !std::isalnum(line[lineIndex]))
+        if (nextWordInLine(line, lineIndex, word))
         {
-            ++lineIndex;
+            return;
         }
 
-        if (lineIndex >= line.length())
-        {
-            advanceToNextLine();
-            continue;
-        }
+        advanceToNextLine();
+    }
+}
 
-        while (lineIndex < line.length() &&
-            (std::isalnum(line[lineIndex]) || line[lineIndex] == '-' || line[lineIndex] == '\''))
-        {
-            word.push_back(std::toupper(line[lineIndex++]));
-        }
 
-        if (!std::isalnum(word[word.length() - 1]))
-        {
-            word.pop_back();
-        }
+bool TextFileReader::nextWordInLine(std::string_view line, std::size_t& index, std::string& word)
+{
+    std::size_t start;
+    std::size_t length;
 
-        if (word.length() > 0)
-        {
-            return;
-        }
+    word.clear();
+
+    if (!nextWordSpanInLine(line, index, start, length))
+    {
+        return false;
+    }
+
+    for (std::size_t i = start; i < start + length; ++i)
+    {
+        word.push_back(std::toupper(line[i]));
     }
+
+    return true;
+}
+
+
+// The words are found by a WordTokenizer, using the fastest implementation
+// that the processor supports, which is chosen the first time it's needed.
+
+bool TextFileReader::nextWordSpanInLine(
+    std::string_view line, std::size_t& index, std::size_t& start, std::size_t& length)
+{
+    static const WordTokenizer tokenizer;
+    return tokenizer.nextWord(line, index, start, length);
 }
 
 
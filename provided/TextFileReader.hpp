@@ -10,8 +10,10 @@
 #ifndef TEXTFILEREADER_HPP
 #define TEXTFILEREADER_HPP
 
+#include <cstddef>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 
 
@@ -26,13 +28,25 @@ public:
     std::string currentLine() const;
     std::string currentWord() const;
 
+    // nextWordInLine() finds the next word in the given line, starting at
+    // the given index, using the same rules as advanceToNextWord().  If
+    // there is one, it's stored (in uppercase) into word, index is moved
+    // past it, and true is returned; otherwise, false is returned.
+    static bool nextWordInLine(std::string_view line, std::size_t& index, std::string& word);
+
+    // nextWordSpanInLine() is like nextWordInLine(), except that rather
+    // than copying the word, it stores where the word starts in the line
+    // and its length (and doesn't convert it to uppercase).
+    static bool nextWordSpanInLine(
+        std::string_view line, std::size_t& index, std::size_t& start, std::size_t& length);
+
 private:
     std::ifstream textFile;
 
     bool eof;
 
     std::string line;
-    int lineIndex;
+    std::size_t lineIndex;
 
     std::string word;
 
@@ -5,30 +5,237 @@
 
 #include <algorithm>
 #include <cctype>
-#include <fstream>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
 #include "WordSetLoader.hpp"
 
 
 
+namespace
+{
+    // Word files smaller than this are read on the calling thread, since
+    // starting threads would cost more than it saves.
+    constexpr std::size_t PARALLEL_THRESHOLD = 256 * 1024;
+
+    // A guess at the average number of bytes per line of a word file,
+    // used to size the list of words before reading them.
+    constexpr std::size_t ESTIMATED_BYTES_PER_WORD = 8;
+}
+
+
+
 void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& wordSet)
 {
-    std::ifstream wordFile{wordFilePath};
+    load(wordFilePath, wordSet, nullptr, nullptr);
+}
+
+
+void WordSetLoader::load(const std::string& wordFilePath, Set<std::string>& wordSet, SuggestionIndex& index)
+{
+    load(wordFilePath, wordSet, &index, nullptr);
+}
 
-    std::string word;
 
-    while (std::getline(wordFile, word))
+unsigned int WordSetLoader::compile(const std::string& wordFilePath, const std::string& imagePath)
+{
+    CompiledWordSet compiled;
+    compiled.build(readWords(wordFilePath));
+
+    if (!compiled.save(imagePath))
+    {
+        throw std::runtime_error{"Cannot write compiled word set: " + imagePath};
+    }
+
+    return compiled.size();
+}
+
+
+void WordSetLoader::load(
+    const std::string& wordFilePath, Set<std::string>& wordSet,
+    SuggestionIndex* index, BloomFilter* filter)
+{
+    CompiledWordSet* compiled = dynamic_cast<CompiledWordSet*>(&wordSet);
+
+    if (compiled != nullptr && CompiledWordSet::isImage(wordFilePath))
     {
-        std::transform(
-            word.begin(), word.end(), word.begin(),
-            [](auto c) { return std::toupper(c); });
+        if (!compiled->open(wordFilePath))
+        {
+            throw std::runtime_error{"Cannot open compiled word set: " + wordFilePath};
+        }
 
-        word.erase(
-            std::remove_if(
-                word.begin(), word.end(),
-                [](auto c) { return c == '\r' || c == '\n'; }),
-            word.end());
+        for (unsigned int i = 0; i < compiled->size(); ++i)
+        {
+            if (index != nullptr)
+            {
+                index->add(compiled->wordAt(i));
+            }
 
-        wordSet.add(word);
+            if (filter != nullptr)
+            {
+                filter->add(compiled->wordAt(i));
+            }
+        }
+
+        return;
+    }
+
+    std::vector<std::string> words = readWords(wordFilePath);
+
+    wordSet.reserve(static_cast<unsigned int>(words.size()));
+    wordSet.bulkLoad(words.data(), words.data() + words.size());
+
+    if (index != nullptr)
+    {
+        for (const std::string& word : words)
+        {
+            index->add(word);
+        }
+    }
+
+    if (filter != nullptr)
+    {
+        for (const std::string& word : words)
+        {
+            filter->add(word);
+        }
     }
 }
 
+
+std::vector<std::string> WordSetLoader::readWords(const std::string& wordFilePath)
+{
+    std::vector<std::string> words;
+
+    if (CompiledWordSet::isImage(wordFilePath))
+    {
+        CompiledWordSet image;
+
+        if (!image.open(wordFilePath))
+        {
+            throw std::runtime_error{"Cannot open compiled word set: " + wordFilePath};
+        }
+
+        words.reserve(image.size());
+
+        for (unsigned int i = 0; i < image.size(); ++i)
+        {
+            words.emplace_back(image.wordAt(i));
+        }
+
+        return words;
+    }
+
+    MappedFile wordFile{wordFilePath};
+    std::string_view text = wordFile.contents();
+
+    unsigned int pieceCount = text.size() >= PARALLEL_THRESHOLD ? ThreadPool::defaultThreadCount() : 1;
+
+    if (pieceCount <= 1)
+    {
+        readLines(text, words);
+        return words;
+    }
+
+    // The text is split into pieces of roughly equal size, each of which
+    // (except the last) ends just after a newline, so that the lines in
+    // the pieces are exactly the lines in the text.
+    std::vector<std::string_view> pieces;
+    std::size_t start = 0;
+
+    for (unsigned int i = 1; i <= pieceCount && start < text.size(); ++i)
+    {
+        std::size_t end = text.size();
+
+        if (i < pieceCount)
+        {
+            end = text.find('\n', std::max(start, text.size() / pieceCount * i));
+            end = end == std::string_view::npos ? text.size() : end + 1;
+        }
+
+        pieces.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    std::vector<std::vector<std::string>> pieceWords(pieces.size());
+
+    {
+        ThreadPool pool{static_cast<unsigned int>(pieces.size())};
+        std::vector<std::future<void>> done;
+
+        for (std::size_t i = 0; i < pieces.size(); ++i)
+        {
+            done.push_back(pool.submit(
+                [&pieces, &pieceWords, i]
+                {
+                    readLines(pieces[i], pieceWords[i]);
+                }));
+        }
+
+        for (std::future<void>& piece : done)
+        {
+            piece.get();
+        }
+    }
+
+    std::size_t total = 0;
+
+    for (const std::vector<std::string>& piece : pieceWords)
+    {
+        total += piece.size();
+    }
+
+    words.reserve(total);
+
+    for (std::vector<std::string>& piece : pieceWords)
+    {
+        std::move(piece.begin(), piece.end(), std::back_inserter(words));
+    }
+
+    return words;
+}
+
+
+// readLines() splits the text into lines the same way that std::getline()
+// would, normalizing each one into a word.
+
+void WordSetLoader::readLines(std::string_view text, std::vector<std::string>& words)
+{
+    words.reserve(words.size() + text.size() / ESTIMATED_BYTES_PER_WORD);
+
+    std::size_t start = 0;
+
+    while (start < text.size())
+    {
+        std::size_t end = text.find('\n', start);
+
+        if (end == std::string_view::npos)
+        {
+            end = text.size();
+        }
+
+        std::string word{text.substr(start, end - start)};
+        normalize(word);
+        words.push_back(std::move(word));
+
+        start = end + 1;
+    }
+}
+
+
+void WordSetLoader::normalize(std::string& word)
+{
+    std::transform(
+        word.begin(), word.end(), word.begin(),
+        [](auto c) { return std::toupper(c); });
+
+    word.erase(
+        std::remove_if(
+            word.begin(), word.end(),
+            [](auto c) { return c == '\r' || c == '\n'; }),
+        word.end());
+}
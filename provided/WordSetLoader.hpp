@@ -4,13 +4,30 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A class that loads a word set from a file containing one word on each
-// line.  The words are then added to the given Set<std::string>.
+// line.  The words are then added to the given Set<std::string> and,
+// optionally, to a SuggestionIndex and/or a BloomFilter (which are left
+// for the caller to build).
+//
+// Large files are split into pieces that are read (and converted to
+// uppercase) on several threads at once.  The words are then handed to the
+// Set all together with bulkLoad(), in the order they appear in the file.
+//
+// The file can instead be a compiled image of a word set (see
+// CompiledWordSet), which compile() writes.  Its words have already been
+// converted to uppercase, so they're added without being parsed.  Loading
+// into a CompiledWordSet is a special case: an image is mapped rather than
+// loaded word by word, and a list of words is compiled in memory.
 
 #ifndef WORDSETLOADER_HPP
 #define WORDSETLOADER_HPP
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include "BloomFilter.hpp"
+#include "CompiledWordSet.hpp"
 #include "Set.hpp"
+#include "SuggestionIndex.hpp"
 
 
 
@@ -18,9 +35,28 @@ class WordSetLoader
 {
 public:
     void load(const std::string& wordFilePath, Set<std::string>& wordSet);
+    void load(const std::string& wordFilePath, Set<std::string>& wordSet, SuggestionIndex& index);
+
+    // This version adds the words to whichever of the index and the filter
+    // aren't nullptr.  Each version throws a std::runtime_error if the file
+    // looks like a compiled image but can't be opened as one.
+    void load(
+        const std::string& wordFilePath, Set<std::string>& wordSet,
+        SuggestionIndex* index, BloomFilter* filter);
+
+    // compile() reads the words from the given file (which may itself be an
+    // image) and writes an image of them to the given path, returning the
+    // number of distinct words written.  It throws a std::runtime_error if
+    // the image can't be written, or if the given file looks like an image
+    // but can't be opened.
+    unsigned int compile(const std::string& wordFilePath, const std::string& imagePath);
+
+private:
+    std::vector<std::string> readWords(const std::string& wordFilePath);
+    static void readLines(std::string_view text, std::vector<std::string>& words);
+    static void normalize(std::string& word);
 };
 
 
 
 #endif // WORDSETLOADER_HPP
-